@@ -0,0 +1,88 @@
+#include "affine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+AffineTransform::AffineTransform()
+    : _a(1.0), _b(0.0), _c(0.0), _d(1.0), _tx(0.0), _ty(0.0)
+{
+}
+
+AffineTransform::AffineTransform(double a, double b, double c, double d,
+                                 double tx, double ty)
+    : _a(a), _b(b), _c(c), _d(d), _tx(tx), _ty(ty)
+{
+}
+
+AffineTransform AffineTransform::Translation(double dx, double dy)
+{
+    return AffineTransform(1.0, 0.0, 0.0, 1.0, dx, dy);
+}
+
+AffineTransform AffineTransform::Scaling(double sx, double sy)
+{
+    return AffineTransform(sx, 0.0, 0.0, sy, 0.0, 0.0);
+}
+
+AffineTransform AffineTransform::Rotation(double radians)
+{
+    double c = std::cos(radians);
+    double s = std::sin(radians);
+    return AffineTransform(c, -s, s, c, 0.0, 0.0);
+}
+
+AffineTransform AffineTransform::Then(const AffineTransform& next) const
+{
+    // next(this(p)): multiply the 3x3 matrices next * this.
+    return AffineTransform(
+        next._a * _a + next._b * _c,
+        next._a * _b + next._b * _d,
+        next._c * _a + next._d * _c,
+        next._c * _b + next._d * _d,
+        next._a * _tx + next._b * _ty + next._tx,
+        next._c * _tx + next._d * _ty + next._ty);
+}
+
+Point AffineTransform::Apply(const Point& point) const
+{
+    double x = point.GetX();
+    double y = point.GetY();
+    return Point(_a * x + _b * y + _tx, _c * x + _d * y + _ty);
+}
+
+void AffineTransform::Apply(double* xs, double* ys, long count, BoundingBox* box) const
+{
+    const double a = _a, b = _b, c = _c, d = _d, tx = _tx, ty = _ty;
+
+    if (box == nullptr) {
+        for (long i = 0; i < count; ++i) {
+            double x = xs[i];
+            double y = ys[i];
+            xs[i] = a * x + b * y + tx;
+            ys[i] = c * x + d * y + ty;
+        }
+        return;
+    }
+
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = std::numeric_limits<double>::infinity();
+    double maxX = -std::numeric_limits<double>::infinity();
+    double maxY = -std::numeric_limits<double>::infinity();
+    for (long i = 0; i < count; ++i) {
+        double x = xs[i];
+        double y = ys[i];
+        double nx = a * x + b * y + tx;
+        double ny = c * x + d * y + ty;
+        xs[i] = nx;
+        ys[i] = ny;
+        minX = std::min(minX, nx);
+        minY = std::min(minY, ny);
+        maxX = std::max(maxX, nx);
+        maxY = std::max(maxY, ny);
+    }
+    box->minX = minX;
+    box->minY = minY;
+    box->maxX = maxX;
+    box->maxY = maxY;
+}
@@ -0,0 +1,108 @@
+#ifndef AFFINE_H
+#define AFFINE_H
+
+#include "point.h"
+
+/**
+ * @struct BoundingBox
+ * @brief Axis-aligned bounding box.
+ *
+ * The box of an empty point set has minX/minY at +infinity and maxX/maxY at
+ * -infinity.
+ */
+struct BoundingBox
+{
+    double minX; ///< Smallest x-coordinate.
+    double minY; ///< Smallest y-coordinate.
+    double maxX; ///< Largest x-coordinate.
+    double maxY; ///< Largest y-coordinate.
+};
+
+/**
+ * @class AffineTransform
+ * @brief A 2D affine map x' = a*x + b*y + tx, y' = c*x + d*y + ty.
+ *
+ * Translations, scalings and rotations are built with the static factories
+ * and chained with Then(), so a whole chain is applied to a dataset in a
+ * single pass.
+ */
+class AffineTransform
+{
+private:
+    double _a;  ///< Coefficient of x in x'.
+    double _b;  ///< Coefficient of y in x'.
+    double _c;  ///< Coefficient of x in y'.
+    double _d;  ///< Coefficient of y in y'.
+    double _tx; ///< Constant term of x'.
+    double _ty; ///< Constant term of y'.
+
+public:
+    /**
+     * @brief Constructs the identity transform.
+     */
+    AffineTransform();
+
+    /**
+     * @brief Constructs a transform from its coefficients.
+     * @param a The coefficient of x in x'.
+     * @param b The coefficient of y in x'.
+     * @param c The coefficient of x in y'.
+     * @param d The coefficient of y in y'.
+     * @param tx The constant term of x'.
+     * @param ty The constant term of y'.
+     */
+    AffineTransform(double a, double b, double c, double d, double tx, double ty);
+
+    /**
+     * @brief Creates a translation.
+     * @param dx The offset along x.
+     * @param dy The offset along y.
+     * @return The translation.
+     */
+    static AffineTransform Translation(double dx, double dy);
+
+    /**
+     * @brief Creates a scaling about the origin.
+     * @param sx The scale factor along x.
+     * @param sy The scale factor along y.
+     * @return The scaling.
+     */
+    static AffineTransform Scaling(double sx, double sy);
+
+    /**
+     * @brief Creates a counterclockwise rotation about the origin.
+     * @param radians The rotation angle in radians.
+     * @return The rotation.
+     */
+    static AffineTransform Rotation(double radians);
+
+    /**
+     * @brief Composes this transform with another one applied afterwards.
+     * @param next The transform to apply after this one.
+     * @return A transform equivalent to applying this one, then @p next.
+     */
+    AffineTransform Then(const AffineTransform& next) const;
+
+    /**
+     * @brief Applies the transform to a point.
+     * @param point The point to transform.
+     * @return The transformed point.
+     */
+    Point Apply(const Point& point) const;
+
+    /**
+     * @brief Transforms coordinate arrays in place.
+     *
+     * The loop body is branch-free straight-line arithmetic on two separate
+     * arrays so the compiler can vectorize it. When @p box is given, the
+     * bounding box of the transformed points is computed in the same pass.
+     *
+     * @param xs The x-coordinates to transform.
+     * @param ys The y-coordinates to transform.
+     * @param count The number of points.
+     * @param box Receives the bounding box of the transformed points (may be nullptr).
+     */
+    void Apply(double* xs, double* ys, long count, BoundingBox* box = nullptr) const;
+};
+
+#endif // AFFINE_H
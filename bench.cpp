@@ -0,0 +1,574 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "point.h"
+#include "polygon.h"
+#include "polygoncollection.h"
+#include "affine.h"
+#include "raster.h"
+#include "pipeline.h"
+
+struct BenchResult {
+    std::string name;
+    double seconds = 0.0;   // best wall time of one run
+    double items = 0.0;     // items processed per run
+};
+
+// Named figures of merit, checked against data/perf_gates.txt in --gate mode.
+// They are speedups of a fast path over its baseline on the same machine, so
+// the thresholds do not depend on how fast the machine is.
+typedef std::map<std::string, double> Metrics;
+
+// Keeps the optimizer from discarding benchmark results.
+static volatile double sink = 0.0;
+
+// Best wall time of several runs of fn.
+template <typename Fn>
+double TimeBest(Fn fn, int repeats = 5) {
+    double best = 1e300;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        if (seconds < best) {
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+void PrintResult(const BenchResult& result) {
+    double rate = result.items / result.seconds;
+    const char* unit = " /s";
+    if (rate >= 1e6) {
+        rate /= 1e6;
+        unit = " M/s";
+    } else if (rate >= 1e3) {
+        rate /= 1e3;
+        unit = " k/s";
+    }
+    std::cout << std::left << std::setw(40) << result.name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(3)
+              << result.seconds * 1e3 << " ms"
+              << std::setw(14) << std::setprecision(2) << rate << unit << "\n";
+}
+
+// Random star-shaped polygon with n points around (cx, cy).
+Polygon RandomPolygon(std::mt19937& rng, int n, double cx, double cy) {
+    std::uniform_real_distribution<double> radius(0.5, 1.0);
+    Polygon polygon(n);
+    for (int i = 0; i < n; ++i) {
+        double angle = 2.0 * M_PI * i / n;
+        double r = radius(rng);
+        polygon.AddPoint(Point(cx + r * std::cos(angle), cy + r * std::sin(angle)));
+    }
+    return polygon;
+}
+
+// Convexity test of Polygon::IsConvex() without its cache, reading the points
+// through GetPoint() the way the vector<Polygon> layout has to.
+bool ScanConvex(const Polygon& polygon) {
+    int n = polygon.GetNumPoints();
+    bool positive = false;
+    bool negative = false;
+    for (int i = 0; i < n; ++i) {
+        const Point& p1 = *polygon.GetPoint(i);
+        const Point& p2 = *polygon.GetPoint((i + 1) % n);
+        const Point& p3 = *polygon.GetPoint((i + 2) % n);
+        double cross = (p2.GetX() - p1.GetX()) * (p3.GetY() - p2.GetY()) -
+                       (p2.GetY() - p1.GetY()) * (p3.GetX() - p2.GetX());
+        positive = positive || cross > 1e-9;
+        negative = negative || cross < -1e-9;
+        if (positive && negative) {
+            return false;
+        }
+    }
+    return n >= 3 && (positive || negative);
+}
+
+// ----------------- Benchmarks -----------------
+
+void BenchCollectionIteration(int count, Metrics& metrics) {
+    std::cout << "\n--- Iteration: std::vector<Polygon> vs PolygonCollection ("
+              << count << " polygons) ---\n";
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> size(4, 16);
+    std::vector<Polygon> polygons;
+    polygons.reserve(count);
+    PolygonCollection collection;
+    for (int i = 0; i < count; ++i) {
+        polygons.push_back(RandomPolygon(rng, size(rng), i % 1000, i / 1000));
+        collection.Append(polygons.back());
+    }
+
+    double points = static_cast<double>(collection.GetNumPoints());
+
+    BenchResult vectorPerimeter{"vector<Polygon> Perimeter (points)", 0.0, points};
+    vectorPerimeter.seconds = TimeBest([&]() {
+        double sum = 0.0;
+        for (const Polygon& polygon : polygons) {
+            sum += polygon.Perimeter();
+        }
+        sink = sum;
+    });
+
+    BenchResult collectionPerimeter{"PolygonCollection Perimeter (points)", 0.0, points};
+    collectionPerimeter.seconds = TimeBest([&]() {
+        double sum = 0.0;
+        for (int i = 0; i < collection.GetNumPolygons(); ++i) {
+            sum += collection.GetPolygon(i).Perimeter();
+        }
+        sink = sum;
+    });
+
+    BenchResult vectorConvex{"vector<Polygon> uncached IsConvex (points)", 0.0, points};
+    vectorConvex.seconds = TimeBest([&]() {
+        int convex = 0;
+        for (const Polygon& polygon : polygons) {
+            convex += ScanConvex(polygon) ? 1 : 0;
+        }
+        sink = convex;
+    });
+
+    BenchResult collectionConvex{"PolygonCollection IsConvex (points)", 0.0, points};
+    collectionConvex.seconds = TimeBest([&]() {
+        int convex = 0;
+        for (int i = 0; i < collection.GetNumPolygons(); ++i) {
+            convex += collection.GetPolygon(i).IsConvex() ? 1 : 0;
+        }
+        sink = convex;
+    });
+
+    PrintResult(vectorPerimeter);
+    PrintResult(collectionPerimeter);
+    PrintResult(vectorConvex);
+    PrintResult(collectionConvex);
+    metrics["collection_perimeter_speedup"] = vectorPerimeter.seconds / collectionPerimeter.seconds;
+    metrics["collection_convex_speedup"] = vectorConvex.seconds / collectionConvex.seconds;
+}
+
+void BenchAffine(int count, Metrics& metrics) {
+    std::cout << "\n--- Bulk affine transform with bounding boxes ("
+              << count << " polygons) ---\n";
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> size(4, 16);
+    std::vector<Polygon> polygons;
+    polygons.reserve(count);
+    PolygonCollection collection;
+    for (int i = 0; i < count; ++i) {
+        polygons.push_back(RandomPolygon(rng, size(rng), i % 1000, i / 1000));
+        collection.Append(polygons.back());
+    }
+    double points = static_cast<double>(collection.GetNumPoints());
+    std::vector<BoundingBox> boxes(count);
+
+    // A rotation keeps coordinates bounded over the repeated runs.
+    AffineTransform transform = AffineTransform::Rotation(0.001);
+
+    BenchResult perVertex{"GetPoint/SetPoint loop (points)", 0.0, points};
+    perVertex.seconds = TimeBest([&]() {
+        for (int i = 0; i < count; ++i) {
+            Polygon& polygon = polygons[i];
+            BoundingBox& box = boxes[i];
+            box = BoundingBox{1e300, 1e300, -1e300, -1e300};
+            for (int k = 0; k < polygon.GetNumPoints(); ++k) {
+                Point moved = transform.Apply(*polygon.GetPoint(k));
+                polygon.SetPoint(k, moved);
+                box.minX = std::min(box.minX, moved.GetX());
+                box.minY = std::min(box.minY, moved.GetY());
+                box.maxX = std::max(box.maxX, moved.GetX());
+                box.maxY = std::max(box.maxY, moved.GetY());
+            }
+        }
+    });
+
+    BenchResult polygonAll{"Polygon::TransformAll (points)", 0.0, points};
+    polygonAll.seconds = TimeBest([&]() {
+        Polygon::TransformAll(polygons.data(), count, transform, boxes.data());
+    });
+
+    BenchResult polygonAllThreads{"Polygon::TransformAll, all threads", 0.0, points};
+    polygonAllThreads.seconds = TimeBest([&]() {
+        Polygon::TransformAll(polygons.data(), count, transform, boxes.data(), 0);
+    });
+
+    BenchResult pooled{"PolygonCollection::Transform (points)", 0.0, points};
+    pooled.seconds = TimeBest([&]() {
+        collection.Transform(transform, boxes.data());
+    });
+
+    BenchResult pooledThreads{"PolygonCollection::Transform, all threads", 0.0, points};
+    pooledThreads.seconds = TimeBest([&]() {
+        collection.Transform(transform, boxes.data(), 0);
+    });
+
+    sink = boxes[count / 2].maxX;
+    PrintResult(perVertex);
+    PrintResult(polygonAll);
+    PrintResult(polygonAllThreads);
+    PrintResult(pooled);
+    PrintResult(pooledThreads);
+    metrics["collection_transform_speedup"] = perVertex.seconds / pooled.seconds;
+}
+
+void BenchEdgeIndex(Metrics& metrics) {
+    const int N = 20000;
+    const int QUERIES = 200;
+    std::cout << "\n--- Distance to boundary: edge hierarchy vs linear scan ("
+              << N << " points, " << QUERIES << " queries) ---\n";
+
+    std::mt19937 rng(3);
+    Polygon polygon = RandomPolygon(rng, N, 0.0, 0.0);
+    std::uniform_real_distribution<double> coord(-1.5, 1.5);
+    std::vector<Point> queries;
+    for (int i = 0; i < QUERIES; ++i) {
+        queries.emplace_back(coord(rng), coord(rng));
+    }
+
+    BenchResult linear{"Linear scan (queries)", 0.0, QUERIES};
+    linear.seconds = TimeBest([&]() {
+        double sum = 0.0;
+        for (const Point& q : queries) {
+            double best = 1e300;
+            for (int i = 0; i < N; ++i) {
+                const Point& a = *polygon.GetPoint(i);
+                const Point& b = *polygon.GetPoint((i + 1) % N);
+                double dx = b.GetX() - a.GetX();
+                double dy = b.GetY() - a.GetY();
+                double t = ((q.GetX() - a.GetX()) * dx + (q.GetY() - a.GetY()) * dy) /
+                           (dx * dx + dy * dy);
+                t = std::clamp(t, 0.0, 1.0);
+                best = std::min(best, q.Distance(Point(a.GetX() + t * dx, a.GetY() + t * dy)));
+            }
+            sum += best;
+        }
+        sink = sum;
+    }, 3);
+
+    polygon.DistanceToBoundary(queries[0]); // build the hierarchy outside the timing
+    BenchResult indexed{"Polygon::DistanceToBoundary (queries)", 0.0, QUERIES};
+    indexed.seconds = TimeBest([&]() {
+        double sum = 0.0;
+        for (const Point& q : queries) {
+            sum += polygon.DistanceToBoundary(q);
+        }
+        sink = sum;
+    });
+
+    PrintResult(linear);
+    PrintResult(indexed);
+    metrics["bvh_boundary_speedup"] = linear.seconds / indexed.seconds;
+}
+
+void BenchConvexDistance(Metrics& metrics) {
+    const int N = 100000;
+    const int QUERIES = 200;
+    std::cout << "\n--- DistanceTo between convex polygons: GJK vs one linear vertex scan ("
+              << N << " points each, " << QUERIES << " queries) ---\n";
+
+    // Two regular polygons, the second one clockwise and moved around.
+    auto circle = [](int n, double cx, double cy, double r, int turn) {
+        Polygon polygon(n);
+        for (int i = 0; i < n; ++i) {
+            double angle = turn * 2.0 * M_PI * i / n;
+            polygon.AddPoint(Point(cx + r * std::cos(angle), cy + r * std::sin(angle)));
+        }
+        return polygon;
+    };
+    const double R = 1e4;
+    Polygon a = circle(N, 0.0, 0.0, R, 1);
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<Polygon> others;
+    for (int i = 0; i < QUERIES / 20; ++i) {
+        double angle = 2.0 * M_PI * unit(rng);
+        double gap = R * (2.05 + unit(rng));
+        others.push_back(circle(N, gap * std::cos(angle), gap * std::sin(angle), R, -1));
+    }
+
+    // The cheapest linear alternative: a single support scan over both polygons.
+    BenchResult scan{"Linear support scan (queries)", 0.0, QUERIES};
+    scan.seconds = TimeBest([&]() {
+        double sum = 0.0;
+        for (int q = 0; q < QUERIES; ++q) {
+            const Polygon& b = others[q % others.size()];
+            double best = -1e300;
+            for (int i = 0; i < N; ++i) {
+                best = std::max(best, a.GetPoint(i)->GetX() - b.GetPoint(i)->GetX());
+            }
+            sum += best;
+        }
+        sink = sum;
+    }, 3);
+
+    for (const Polygon& b : others) {
+        a.DistanceTo(b); // classify the polygons outside the timing
+    }
+    BenchResult gjk{"Polygon::DistanceTo, convex (queries)", 0.0, QUERIES};
+    gjk.seconds = TimeBest([&]() {
+        double sum = 0.0;
+        for (int q = 0; q < QUERIES; ++q) {
+            sum += a.DistanceTo(others[q % others.size()]);
+        }
+        sink = sum;
+    });
+
+    PrintResult(scan);
+    PrintResult(gjk);
+    metrics["convex_distance_speedup"] = scan.seconds / gjk.seconds;
+}
+
+void BenchConvexLocate(Metrics& metrics) {
+    std::cout << "\n--- LocatePoint on convex polygons: wedge search vs linear crossing test ---\n";
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int n = 10; n <= 1000000; n *= 10) {
+        // A regular polygon, large enough that its turns stay above the 1e-9
+        // tolerance of IsConvex() at a million vertices.
+        const double R = 1e4;
+        double phase = 2.0 * M_PI * unit(rng);
+        Polygon polygon(n);
+        for (int i = 0; i < n; ++i) {
+            double angle = phase + 2.0 * M_PI * i / n;
+            polygon.AddPoint(Point(R * std::cos(angle), R * std::sin(angle)));
+        }
+
+        const int QUERIES = std::max(20, 2000000 / n);
+        std::vector<Point> queries;
+        for (int i = 0; i < QUERIES; ++i) {
+            queries.emplace_back(R * (2.2 * unit(rng) - 1.1), R * (2.2 * unit(rng) - 1.1));
+        }
+
+        std::string size = " (n = " + std::to_string(n) + ", queries)";
+        BenchResult linear{"LocatePointLinear" + size, 0.0, static_cast<double>(QUERIES)};
+        linear.seconds = TimeBest([&]() {
+            int inside = 0;
+            for (const Point& q : queries) {
+                inside += polygon.LocatePointLinear(q) == PointLocation::Inside ? 1 : 0;
+            }
+            sink = inside;
+        }, 3);
+
+        polygon.LocatePoint(queries[0]); // classify the polygon outside the timing
+        BenchResult wedge{"LocatePoint" + size, 0.0, static_cast<double>(QUERIES)};
+        wedge.seconds = TimeBest([&]() {
+            int inside = 0;
+            for (const Point& q : queries) {
+                inside += polygon.LocatePoint(q) == PointLocation::Inside ? 1 : 0;
+            }
+            sink = inside;
+        });
+
+        PrintResult(linear);
+        PrintResult(wedge);
+        if (n == 10000) {
+            metrics["convex_locate_speedup"] = linear.seconds / wedge.seconds;
+        }
+    }
+}
+
+void BenchRasterizer(Metrics& metrics) {
+    const int N = 500;
+    const int SIZE = 200;
+    std::cout << "\n--- FillMask: tile-bucketed scanline fill vs per-cell LocatePoint ("
+              << N << " points, " << SIZE << "x" << SIZE << " cells) ---\n";
+
+    std::mt19937 rng(13);
+    Polygon polygon = RandomPolygon(rng, N, 0.0, 0.0);
+    Rasterizer raster(SIZE, SIZE, -1.0, -1.0, 2.0 / SIZE);
+    std::vector<unsigned char> mask(SIZE * SIZE);
+    double cells = static_cast<double>(SIZE) * SIZE;
+
+    BenchResult perCell{"LocatePoint per cell center (cells)", 0.0, cells};
+    perCell.seconds = TimeBest([&]() {
+        for (int row = 0; row < SIZE; ++row) {
+            for (int col = 0; col < SIZE; ++col) {
+                Point center(-1.0 + (col + 0.5) * 2.0 / SIZE, -1.0 + (row + 0.5) * 2.0 / SIZE);
+                mask[row * SIZE + col] = polygon.LocatePoint(center) == PointLocation::Inside;
+            }
+        }
+        sink = mask[SIZE * SIZE / 2];
+    }, 3);
+
+    BenchResult fill{"Rasterizer::FillMask (cells)", 0.0, cells};
+    fill.seconds = TimeBest([&]() {
+        std::fill(mask.begin(), mask.end(), 0);
+        raster.FillMask(polygon, mask.data());
+        sink = mask[SIZE * SIZE / 2];
+    });
+
+    BenchResult fillThreads{"Rasterizer::FillMask, all threads", 0.0, cells};
+    fillThreads.seconds = TimeBest([&]() {
+        std::fill(mask.begin(), mask.end(), 0);
+        raster.FillMask(polygon, mask.data(), 0);
+        sink = mask[SIZE * SIZE / 2];
+    });
+
+    PrintResult(perCell);
+    PrintResult(fill);
+    PrintResult(fillThreads);
+    metrics["raster_fill_speedup"] = perCell.seconds / fill.seconds;
+}
+
+void BenchPipeline(Metrics& metrics) {
+    const int COUNT = 1500;
+    const int N = 64;
+    const int GRID = 16;
+    int hardware = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    int maxWorkers = std::max(hardware, 2);
+    std::cout << "\n--- PolygonPipeline: throughput vs metric workers (" << COUNT
+              << " polygons of " << N << " points, " << hardware << " hardware threads) ---\n";
+
+    std::mt19937 rng(17);
+    std::ostringstream text;
+    for (int i = 0; i < COUNT; ++i) {
+        Polygon polygon = RandomPolygon(rng, N, 0.0, 0.0);
+        text << N << "\n";
+        for (int k = 0; k < N; ++k) {
+            text << polygon.GetPoint(k)->GetX() << "," << polygon.GetPoint(k)->GetY() << "\n";
+        }
+        text << "No\n" << N << "\n0\n\n";
+    }
+    const std::string input = text.str();
+
+    // A compute-bound metric stage, so the parser does not cap the scaling:
+    // the usual metrics plus a grid of point-location queries.
+    auto metric = [](PolygonRecord& record) {
+        PolygonPipeline::ComputeMetrics(record);
+        int inside = 0;
+        for (int row = 0; row < GRID; ++row) {
+            for (int col = 0; col < GRID; ++col) {
+                Point q(-1.0 + (col + 0.5) * 2.0 / GRID, -1.0 + (row + 0.5) * 2.0 / GRID);
+                inside += record.polygon->LocatePoint(q) == PointLocation::Inside ? 1 : 0;
+            }
+        }
+        record.perimeter += inside;
+    };
+
+    double single = 0.0;
+    double widest = 0.0;
+    for (int workers = 1; ; workers = std::min(2 * workers, maxWorkers)) {
+        PolygonPipeline pipeline(workers);
+        BenchResult run{"Pipeline, " + std::to_string(workers) + " worker(s) (polygons)",
+                        0.0, static_cast<double>(COUNT)};
+        run.seconds = TimeBest([&]() {
+            std::istringstream in(input);
+            double sum = 0.0;
+            pipeline.Run(in, metric, [&](const PolygonRecord& record) {
+                sum += record.perimeter;
+            });
+            sink = sum;
+        }, 3);
+        PrintResult(run);
+        if (workers == 1) {
+            single = run.seconds;
+        }
+        if (workers == maxWorkers) {
+            widest = run.seconds;
+            break;
+        }
+    }
+
+    // Speedup per core the workers can actually run on, so a machine with
+    // fewer cores than workers is not expected to scale past its cores.
+    metrics["pipeline_worker_efficiency"] =
+        (single / widest) / std::min(maxWorkers, hardware);
+}
+
+// Compares the metrics with the minimums listed in a gates file, one
+// "name minimum" pair per line ('#' starts a comment). Returns the number of
+// failed gates; a gate naming an unknown metric fails too.
+int CheckGates(const std::string& filename, const Metrics& metrics) {
+    std::ifstream fin(filename);
+    if (!fin.is_open()) {
+        std::cerr << "Error: cannot open " << filename << "\n";
+        return 1;
+    }
+
+    std::cout << "\n=== PERFORMANCE GATES ===\n";
+    int failed = 0;
+    std::string line;
+    while (std::getline(fin, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name;
+        double minimum;
+        if (!(fields >> name)) {
+            continue;
+        }
+        if (!(fields >> minimum)) {
+            std::cerr << "[FAIL] malformed gate: " << line << "\n";
+            ++failed;
+            continue;
+        }
+        auto found = metrics.find(name);
+        if (found == metrics.end()) {
+            std::cerr << "[FAIL] " << name << ": no such metric\n";
+            ++failed;
+            continue;
+        }
+        bool ok = found->second >= minimum;
+        (ok ? std::cout : std::cerr) << (ok ? "[PASS] " : "[FAIL] ") << name << ": "
+                                     << std::setprecision(2) << found->second
+                                     << "x (minimum " << minimum << "x)\n";
+        failed += ok ? 0 : 1;
+    }
+    return failed;
+}
+
+// ----------------- main -----------------
+
+int main(int argc, char* argv[]) {
+    // Usage: polygon_bench [--gate gates-file] [polygon-count]
+    std::string gates;
+    int count = 200000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--gate" && i + 1 < argc) {
+            gates = argv[++i];
+        } else {
+            count = std::atoi(argv[i]);
+        }
+    }
+
+    Metrics metrics;
+    BenchCollectionIteration(count, metrics);
+    BenchAffine(count, metrics);
+    BenchEdgeIndex(metrics);
+    BenchConvexDistance(metrics);
+    BenchConvexLocate(metrics);
+    BenchRasterizer(metrics);
+    BenchPipeline(metrics);
+
+    std::cout << "\n--- Speedups ---\n";
+    for (const auto& [name, value] : metrics) {
+        std::cout << std::left << std::setw(40) << name << std::right
+                  << std::setprecision(2) << value << "x\n";
+    }
+
+    if (gates.empty()) {
+        return 0;
+    }
+    int failed = CheckGates(gates, metrics);
+    if (failed > 0) {
+        std::cout << failed << " performance gate(s) FAILED.\n";
+        return 1;
+    }
+    std::cout << "All performance gates PASSED.\n";
+    return 0;
+}
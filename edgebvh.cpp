@@ -0,0 +1,286 @@
+#include "edgebvh.h"
+#include "polygon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const int LEAF_SIZE = 4;
+
+// Median splits halve the edge count at every level, so even 2^31 edges
+// give a tree far shallower than this; a depth-first stack holds at most one
+// pending sibling per level plus the node being expanded.
+const int MAX_STACK = 64;
+
+// Squared distance from (px, py) to the segment (ax, ay)-(bx, by).
+double SegmentDistanceSq(double px, double py,
+                         double ax, double ay, double bx, double by)
+{
+    double dx = bx - ax;
+    double dy = by - ay;
+    double lenSq = dx * dx + dy * dy;
+    double t = 0.0;
+    if (lenSq > 0.0) {
+        // Axis-aligned edges skip the zero term, so infinite queries do not
+        // turn into inf * 0.
+        double along = 0.0;
+        if (dx != 0.0) along += (px - ax) * dx;
+        if (dy != 0.0) along += (py - ay) * dy;
+        t = along / lenSq;
+    }
+    // Clamped ends use the endpoint itself, so the two edges meeting at a
+    // vertex are at exactly the same distance from points beyond it.
+    double cx, cy;
+    if (t <= 0.0) {
+        cx = ax - px;
+        cy = ay - py;
+    } else if (t >= 1.0) {
+        cx = bx - px;
+        cy = by - py;
+    } else {
+        cx = ax + t * dx - px;
+        cy = ay + t * dy - py;
+    }
+    return cx * cx + cy * cy;
+}
+
+double Orientation(double ax, double ay, double bx, double by, double cx, double cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// Squared distance between two segments. Properly crossing segments are at
+// distance 0; every other case is attained at one of the four endpoints.
+double SegmentSegmentDistanceSq(double ax, double ay, double bx, double by,
+                                double cx, double cy, double dx, double dy)
+{
+    double o1 = Orientation(ax, ay, bx, by, cx, cy);
+    double o2 = Orientation(ax, ay, bx, by, dx, dy);
+    double o3 = Orientation(cx, cy, dx, dy, ax, ay);
+    double o4 = Orientation(cx, cy, dx, dy, bx, by);
+    if (((o1 > 0 && o2 < 0) || (o1 < 0 && o2 > 0)) &&
+        ((o3 > 0 && o4 < 0) || (o3 < 0 && o4 > 0))) {
+        return 0.0;
+    }
+    double best = SegmentDistanceSq(ax, ay, cx, cy, dx, dy);
+    best = std::min(best, SegmentDistanceSq(bx, by, cx, cy, dx, dy));
+    best = std::min(best, SegmentDistanceSq(cx, cy, ax, ay, bx, by));
+    best = std::min(best, SegmentDistanceSq(dx, dy, ax, ay, bx, by));
+    return best;
+}
+
+template <typename Box>
+double PointBoxDistanceSq(double x, double y, const Box& box)
+{
+    double dx = std::max({box.minX - x, 0.0, x - box.maxX});
+    double dy = std::max({box.minY - y, 0.0, y - box.maxY});
+    return dx * dx + dy * dy;
+}
+
+template <typename Box>
+double BoxBoxDistanceSq(const Box& a, const Box& b)
+{
+    double dx = std::max({a.minX - b.maxX, 0.0, b.minX - a.maxX});
+    double dy = std::max({a.minY - b.maxY, 0.0, b.minY - a.maxY});
+    return dx * dx + dy * dy;
+}
+
+} // namespace
+
+EdgeBVH::EdgeBVH(const Polygon& polygon)
+{
+    int n = polygon.GetNumPoints();
+    if (n == 0) {
+        return;
+    }
+
+    std::vector<double> xs(n), ys(n);
+    for (int i = 0; i < n; ++i) {
+        const Point* p = polygon.GetPoint(i);
+        xs[i] = p->GetX();
+        ys[i] = p->GetY();
+    }
+
+    std::vector<int> edges(n);
+    std::vector<double> midX(n), midY(n);
+    for (int i = 0; i < n; ++i) {
+        int j = (i + 1) % n;
+        edges[i] = i;
+        midX[i] = 0.5 * (xs[i] + xs[j]);
+        midY[i] = 0.5 * (ys[i] + ys[j]);
+    }
+
+    _nodes.reserve(2 * (n / LEAF_SIZE + 1));
+    Build(edges, midX, midY, 0, n, xs, ys);
+
+    // Lay the endpoints out in slot order so every leaf is one contiguous run.
+    _edges = edges;
+    _ax.resize(n);
+    _ay.resize(n);
+    _bx.resize(n);
+    _by.resize(n);
+    for (int s = 0; s < n; ++s) {
+        int i = _edges[s];
+        int j = (i + 1) % n;
+        _ax[s] = xs[i];
+        _ay[s] = ys[i];
+        _bx[s] = xs[j];
+        _by[s] = ys[j];
+    }
+}
+
+int EdgeBVH::Build(std::vector<int>& edges, std::vector<double>& midX,
+                   std::vector<double>& midY, int begin, int end,
+                   const std::vector<double>& xs, const std::vector<double>& ys)
+{
+    int n = static_cast<int>(xs.size());
+    Node node;
+    node.minX = node.minY = std::numeric_limits<double>::infinity();
+    node.maxX = node.maxY = -std::numeric_limits<double>::infinity();
+    double cMinX = node.minX, cMinY = node.minY;
+    double cMaxX = node.maxX, cMaxY = node.maxY;
+    for (int s = begin; s < end; ++s) {
+        int i = edges[s];
+        int j = (i + 1) % n;
+        node.minX = std::min({node.minX, xs[i], xs[j]});
+        node.minY = std::min({node.minY, ys[i], ys[j]});
+        node.maxX = std::max({node.maxX, xs[i], xs[j]});
+        node.maxY = std::max({node.maxY, ys[i], ys[j]});
+        cMinX = std::min(cMinX, midX[i]);
+        cMinY = std::min(cMinY, midY[i]);
+        cMaxX = std::max(cMaxX, midX[i]);
+        cMaxY = std::max(cMaxY, midY[i]);
+    }
+
+    int index = static_cast<int>(_nodes.size());
+    if (end - begin <= LEAF_SIZE) {
+        node.first = begin;
+        node.count = end - begin;
+        _nodes.push_back(node);
+        return index;
+    }
+
+    node.first = 0;
+    node.count = 0;
+    _nodes.push_back(node);
+
+    // Median split on the longer axis of the edge midpoints.
+    const std::vector<double>& key = (cMaxX - cMinX >= cMaxY - cMinY) ? midX : midY;
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(edges.begin() + begin, edges.begin() + mid, edges.begin() + end,
+                     [&key](int a, int b) { return key[a] < key[b]; });
+
+    Build(edges, midX, midY, begin, mid, xs, ys);
+    int right = Build(edges, midX, midY, mid, end, xs, ys);
+    _nodes[index].first = right;
+    return index;
+}
+
+int EdgeBVH::GetNumEdges() const
+{
+    return static_cast<int>(_edges.size());
+}
+
+int EdgeBVH::Nearest(double x, double y, double& distance) const
+{
+    if (_nodes.empty()) {
+        distance = -1.0;
+        return -1;
+    }
+
+    double bestSq = std::numeric_limits<double>::infinity();
+    int bestSlot = -1;
+
+    int stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        int nodeIndex = stack[--top];
+        const Node& node = _nodes[nodeIndex];
+        // Boxes exactly as far as the best edge may still hold a tied edge
+        // with a lower index.
+        if (PointBoxDistanceSq(x, y, node) > bestSq) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (int s = node.first; s < node.first + node.count; ++s) {
+                double d = SegmentDistanceSq(x, y, _ax[s], _ay[s], _bx[s], _by[s]);
+                // Queries infinite along both axes can still give NaN for
+                // some edges (inf - inf); any other distance replaces it.
+                if (bestSlot < 0 || std::isnan(bestSq) || d < bestSq ||
+                    (d == bestSq && _edges[s] < _edges[bestSlot])) {
+                    bestSq = d;
+                    bestSlot = s;
+                }
+            }
+            continue;
+        }
+        // Push the farther child first so the nearer one is searched first.
+        int left = nodeIndex + 1;
+        int right = node.first;
+        double dl = PointBoxDistanceSq(x, y, _nodes[left]);
+        double dr = PointBoxDistanceSq(x, y, _nodes[right]);
+        if (dl <= dr) {
+            stack[top++] = right;
+            stack[top++] = left;
+        } else {
+            stack[top++] = left;
+            stack[top++] = right;
+        }
+    }
+
+    // A NaN coordinate makes every distance NaN; no edge is closest.
+    if (std::isnan(bestSq)) {
+        distance = bestSq;
+        return -1;
+    }
+    distance = std::sqrt(bestSq);
+    return _edges[bestSlot];
+}
+
+double EdgeBVH::Distance(const EdgeBVH& other) const
+{
+    if (_nodes.empty() || other._nodes.empty()) {
+        return -1.0;
+    }
+
+    double bestSq = std::numeric_limits<double>::infinity();
+
+    std::vector<std::pair<int, int>> stack;
+    stack.emplace_back(0, 0);
+    while (!stack.empty() && bestSq > 0.0) {
+        auto [ia, ib] = stack.back();
+        stack.pop_back();
+        const Node& a = _nodes[ia];
+        const Node& b = other._nodes[ib];
+        if (BoxBoxDistanceSq(a, b) >= bestSq) {
+            continue;
+        }
+        if (a.count > 0 && b.count > 0) {
+            for (int s = a.first; s < a.first + a.count; ++s) {
+                for (int t = b.first; t < b.first + b.count; ++t) {
+                    double d = SegmentSegmentDistanceSq(
+                        _ax[s], _ay[s], _bx[s], _by[s],
+                        other._ax[t], other._ay[t], other._bx[t], other._by[t]);
+                    bestSq = std::min(bestSq, d);
+                }
+            }
+            continue;
+        }
+        // Descend into the larger box, or the only inner node.
+        double areaA = (a.maxX - a.minX) * (a.maxY - a.minY);
+        double areaB = (b.maxX - b.minX) * (b.maxY - b.minY);
+        if (b.count > 0 || (a.count == 0 && areaA >= areaB)) {
+            stack.emplace_back(a.first, ib);
+            stack.emplace_back(ia + 1, ib);
+        } else {
+            stack.emplace_back(ia, b.first);
+            stack.emplace_back(ia, ib + 1);
+        }
+    }
+
+    return std::sqrt(bestSq);
+}
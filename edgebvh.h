@@ -0,0 +1,76 @@
+#ifndef EDGEBVH_H
+#define EDGEBVH_H
+
+#include <vector>
+
+class Polygon;
+
+/**
+ * @class EdgeBVH
+ * @brief Bounding volume hierarchy over the edges of a polygon.
+ *
+ * Edge @c i joins vertex @c i to vertex @c (i + 1) % n. The hierarchy keeps its
+ * own copy of the edge endpoints, so queries never chase the polygon's
+ * individually allocated points. It is a snapshot of the polygon at build time
+ * and must be rebuilt after the polygon changes.
+ */
+class EdgeBVH
+{
+private:
+    /// A node of the hierarchy. Nodes are stored in depth-first order, so the
+    /// left child of an inner node always follows it directly.
+    struct Node {
+        double minX, minY, maxX, maxY; ///< Bounding box of all edges below.
+        int first; ///< Leaf: first slot of its edges. Inner: index of the right child.
+        int count; ///< Leaf: number of edges. Inner: 0.
+    };
+
+    std::vector<Node> _nodes;   ///< Nodes, root at index 0.
+    std::vector<int> _edges;    ///< Original edge index of each slot.
+    std::vector<double> _ax;    ///< Start x of the edge in each slot.
+    std::vector<double> _ay;    ///< Start y of the edge in each slot.
+    std::vector<double> _bx;    ///< End x of the edge in each slot.
+    std::vector<double> _by;    ///< End y of the edge in each slot.
+
+    int Build(std::vector<int>& edges, std::vector<double>& midX,
+              std::vector<double>& midY, int begin, int end,
+              const std::vector<double>& xs, const std::vector<double>& ys);
+
+public:
+    /**
+     * @brief Builds the hierarchy over the edges of a polygon.
+     * @param polygon The polygon whose edges are indexed.
+     */
+    explicit EdgeBVH(const Polygon& polygon);
+
+    /**
+     * @brief Gets the number of edges in the hierarchy.
+     * @return The number of edges, equal to the polygon's number of points.
+     */
+    int GetNumEdges() const;
+
+    /**
+     * @brief Finds the edge closest to a point.
+     *
+     * @param x The x-coordinate of the query point.
+     * @param y The y-coordinate of the query point.
+     * @param distance Receives the distance to the closest edge, -1.0 if there
+     *        are no edges, or NaN if a coordinate is NaN.
+     * @return The index of the closest edge, or -1 if there are no edges or a
+     *         coordinate is NaN.
+     */
+    int Nearest(double x, double y, double& distance) const;
+
+    /**
+     * @brief Computes the minimum distance between the edges of two hierarchies.
+     *
+     * Both trees are descended together and pairs of boxes farther apart than
+     * the best distance found so far are skipped. Crossing edges give 0.
+     *
+     * @param other The other hierarchy.
+     * @return The minimum edge-to-edge distance, or -1.0 if either is empty.
+     */
+    double Distance(const EdgeBVH& other) const;
+};
+
+#endif // EDGEBVH_H
@@ -5,6 +5,7 @@
 
 #include "point.h"
 #include "polygon.h"
+#include "pipeline.h"
 
 struct TestStats {
     int passed = 0;
@@ -34,59 +35,26 @@ int main() {
     }
 
     TestStats stats;
-    int polygonIndex = 0;
 
-    while (true) {
-        int n;
-        if (!(fin >> n)) {
-            break; // no more polygons
-        }
-        ++polygonIndex;
-
-        Polygon poly(n);
-
-        // Read n points as "x,y"
-        for (int i = 0; i < n; ++i) {
-            double x, y;
-            char comma;
-            if (!(fin >> x >> comma >> y) || comma != ',') {
-                std::cerr << "[ERROR] Bad point format in polygon " << polygonIndex << "\n";
-                return 1;
-            }
-            poly.AddPoint(Point(x, y));
-        }
-
-        // Read expected convex flag ("Yes" / "No")
-        std::string convexStr;
-        if (!(fin >> convexStr)) {
-            std::cerr << "[ERROR] Missing convex flag in polygon " << polygonIndex << "\n";
-            return 1;
-        }
+    // Reading, parsing and the IsConvex/Perimeter metrics run on their own
+    // threads; this callback sees the polygons in file order.
+    PolygonPipeline pipeline;
+    long count = pipeline.Run(fin, [&stats](const PolygonRecord& record) {
+        const Polygon& poly = *record.polygon;
+        const std::string& convexStr = record.convexFlag;
         bool expectedConvex =
             (convexStr == "Yes" || convexStr == "yes" ||
              convexStr == "Y"   || convexStr == "y");
+        int expectedNumPoints = record.expectedNumPoints;
+        double expectedPerimeter = record.expectedPerimeter;
 
-        // Read expected number of points
-        int expectedNumPoints;
-        if (!(fin >> expectedNumPoints)) {
-            std::cerr << "[ERROR] Missing expectedNumPoints in polygon " << polygonIndex << "\n";
-            return 1;
-        }
-
-        // Read expected perimeter
-        double expectedPerimeter;
-        if (!(fin >> expectedPerimeter)) {
-            std::cerr << "[ERROR] Missing expectedPerimeter in polygon " << polygonIndex << "\n";
-            return 1;
-        }
-
-        std::cout << "=== Polygon " << polygonIndex << " ===\n";
+        std::cout << "=== Polygon " << record.index + 1 << " ===\n";
         std::cout << poly.ToString() << "\n";
 
         // ---- Actual values from code ----
         int actualNumPoints = poly.GetNumPoints();
-        bool actualConvex   = poly.IsConvex();
-        double actualPerimeterRaw = poly.Perimeter();
+        bool actualConvex   = record.convex;
+        double actualPerimeterRaw = record.perimeter;
         double actualEffectivePerimeter =
             actualConvex ? actualPerimeterRaw : 0.0;
 
@@ -111,6 +79,11 @@ int main() {
         std::cout << "Effective perimeter: "<< actualEffectivePerimeter << "\n";
         std::cout << "Expected convex: "    << convexStr << "\n";
         std::cout << "Expected perimeter: " << expectedPerimeter << "\n\n";
+    });
+
+    if (count < 0) {
+        std::cerr << "[ERROR] " << pipeline.GetError() << "\n";
+        return 1;
     }
 
     std::cout << "=== TEST SUMMARY ===\n";
@@ -118,4 +91,4 @@ int main() {
     std::cout << "Failed: " << stats.failed << "\n";
 
     return (stats.failed == 0) ? 0 : 1;
-}
\ No newline at end of file
+}
@@ -0,0 +1,492 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "point.h"
+#include "polygon.h"
+#include "polygoncollection.h"
+#include "affine.h"
+#include "raster.h"
+#include "pipeline.h"
+
+// Differential tests: every fast path is compared against a slow, independent
+// reference on randomly generated polygons. Run as
+//   polygon_fuzz [iterations] [seed]
+// and rerun a failure with the seed it prints.
+
+struct TestStats {
+    int passed = 0;
+    int failed = 0;
+};
+
+static const int MAX_REPORTED = 20;
+
+void Report(const std::string& name, bool condition, TestStats& stats, int iteration) {
+    if (condition) {
+        ++stats.passed;
+        return;
+    }
+    ++stats.failed;
+    if (stats.failed <= MAX_REPORTED) {
+        std::cerr << "[FAIL] " << name << " (iteration " << iteration << ")" << std::endl;
+    }
+}
+
+// ----------------- Generators -----------------
+
+// Convex polygon: points at sorted random angles on a random rotated ellipse.
+Polygon RandomConvex(std::mt19937& rng, int n) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> angles(n);
+    for (double& angle : angles) {
+        angle = 2.0 * M_PI * unit(rng);
+    }
+    std::sort(angles.begin(), angles.end());
+    angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+
+    double rx = 1.0 + 9.0 * unit(rng);
+    double ry = 1.0 + 9.0 * unit(rng);
+    AffineTransform place = AffineTransform::Rotation(2.0 * M_PI * unit(rng))
+        .Then(AffineTransform::Translation(40.0 * unit(rng) - 20.0, 40.0 * unit(rng) - 20.0));
+
+    Polygon polygon(static_cast<int>(angles.size()));
+    for (double angle : angles) {
+        polygon.AddPoint(place.Apply(Point(rx * std::cos(angle), ry * std::sin(angle))));
+    }
+    return polygon;
+}
+
+// Simple polygon: star-shaped around a center, with random radii.
+Polygon RandomSimple(std::mt19937& rng, int n) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> angles(n);
+    for (double& angle : angles) {
+        angle = 2.0 * M_PI * unit(rng);
+    }
+    std::sort(angles.begin(), angles.end());
+    angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+
+    double cx = 40.0 * unit(rng) - 20.0;
+    double cy = 40.0 * unit(rng) - 20.0;
+    Polygon polygon(static_cast<int>(angles.size()));
+    for (double angle : angles) {
+        double r = 1.0 + 9.0 * unit(rng);
+        polygon.AddPoint(Point(cx + r * std::cos(angle), cy + r * std::sin(angle)));
+    }
+    return polygon;
+}
+
+// Copy of a polygon with some vertices repeated and, half of the time, the
+// first vertex repeated at the end as in a closed ring.
+Polygon WithRepeats(const Polygon& polygon, std::mt19937& rng) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    int n = polygon.GetNumPoints();
+    Polygon repeated(3 * n + 1);
+    for (int i = 0; i < n; ++i) {
+        repeated.AddPoint(*polygon.GetPoint(i));
+        for (int copies = 0; copies < 2 && unit(rng) < 0.2; ++copies) {
+            repeated.AddPoint(*polygon.GetPoint(i));
+        }
+    }
+    if (unit(rng) < 0.5) {
+        repeated.AddPoint(*polygon.GetPoint(0));
+    }
+    return repeated;
+}
+
+// ----------------- Slow references -----------------
+
+double RefCross(const Point* a, const Point* b, const Point* c) {
+    return (b->GetX() - a->GetX()) * (c->GetY() - a->GetY()) -
+           (b->GetY() - a->GetY()) * (c->GetX() - a->GetX());
+}
+
+double RefSegmentDistance(double px, double py, double ax, double ay, double bx, double by) {
+    double dx = bx - ax;
+    double dy = by - ay;
+    double lenSq = dx * dx + dy * dy;
+    double t = lenSq > 0.0 ? ((px - ax) * dx + (py - ay) * dy) / lenSq : 0.0;
+    t = std::max(0.0, std::min(1.0, t));
+    return std::hypot(ax + t * dx - px, ay + t * dy - py);
+}
+
+double RefBoundaryDistance(const Polygon& polygon, const Point& q) {
+    int n = polygon.GetNumPoints();
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < n; ++i) {
+        const Point* a = polygon.GetPoint(i);
+        const Point* b = polygon.GetPoint((i + 1) % n);
+        best = std::min(best, RefSegmentDistance(q.GetX(), q.GetY(),
+                                                 a->GetX(), a->GetY(), b->GetX(), b->GetY()));
+    }
+    return best;
+}
+
+// Winding number; nonzero means inside. Only meaningful away from the boundary.
+int RefWinding(const Polygon& polygon, const Point& q) {
+    int n = polygon.GetNumPoints();
+    int winding = 0;
+    for (int i = 0; i < n; ++i) {
+        const Point* a = polygon.GetPoint(i);
+        const Point* b = polygon.GetPoint((i + 1) % n);
+        double cross = (b->GetX() - a->GetX()) * (q.GetY() - a->GetY()) -
+                       (b->GetY() - a->GetY()) * (q.GetX() - a->GetX());
+        if (a->GetY() <= q.GetY()) {
+            if (b->GetY() > q.GetY() && cross > 0) ++winding;
+        } else {
+            if (b->GetY() <= q.GetY() && cross < 0) --winding;
+        }
+    }
+    return winding;
+}
+
+double RefPerimeter(const Polygon& polygon) {
+    int n = polygon.GetNumPoints();
+    long double sum = 0.0L;
+    for (int i = 0; i < n; ++i) {
+        const Point* a = polygon.GetPoint(i);
+        const Point* b = polygon.GetPoint((i + 1) % n);
+        long double dx = static_cast<long double>(a->GetX()) - b->GetX();
+        long double dy = static_cast<long double>(a->GetY()) - b->GetY();
+        sum += std::sqrt(dx * dx + dy * dy);
+    }
+    return static_cast<double>(sum);
+}
+
+// Convex iff every vertex lies on the same side of every edge (O(n^2)).
+bool RefIsConvex(const Polygon& polygon) {
+    int n = polygon.GetNumPoints();
+    if (n < 3) return false;
+    int sign = 0;
+    for (int i = 0; i < n; ++i) {
+        const Point* a = polygon.GetPoint(i);
+        const Point* b = polygon.GetPoint((i + 1) % n);
+        for (int k = 0; k < n; ++k) {
+            const Point* c = polygon.GetPoint(k);
+            double cross = RefCross(a, b, c);
+            int s = cross > 1e-7 ? 1 : (cross < -1e-7 ? -1 : 0);
+            if (s != 0) {
+                if (sign != 0 && s != sign) return false;
+                sign = s;
+            }
+        }
+    }
+    return sign != 0;
+}
+
+double RefPolygonDistance(const Polygon& a, const Polygon& b) {
+    if (RefWinding(b, *a.GetPoint(0)) != 0 || RefWinding(a, *b.GetPoint(0)) != 0) {
+        return 0.0;
+    }
+    // Crossing edges count as distance 0.
+    int n = a.GetNumPoints();
+    int m = b.GetNumPoints();
+    double best = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < n; ++i) {
+        const Point* p = a.GetPoint(i);
+        const Point* q = a.GetPoint((i + 1) % n);
+        for (int j = 0; j < m; ++j) {
+            const Point* r = b.GetPoint(j);
+            const Point* s = b.GetPoint((j + 1) % m);
+            double d1 = RefCross(p, q, r);
+            double d2 = RefCross(p, q, s);
+            double d3 = RefCross(r, s, p);
+            double d4 = RefCross(r, s, q);
+            if (((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0))) {
+                return 0.0;
+            }
+            best = std::min({best,
+                RefSegmentDistance(p->GetX(), p->GetY(), r->GetX(), r->GetY(), s->GetX(), s->GetY()),
+                RefSegmentDistance(q->GetX(), q->GetY(), r->GetX(), r->GetY(), s->GetX(), s->GetY()),
+                RefSegmentDistance(r->GetX(), r->GetY(), p->GetX(), p->GetY(), q->GetX(), q->GetY()),
+                RefSegmentDistance(s->GetX(), s->GetY(), p->GetX(), p->GetY(), q->GetX(), q->GetY())});
+        }
+    }
+    return best;
+}
+
+bool Close(double a, double b, double relative = 1e-9) {
+    return std::fabs(a - b) <= relative * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+// ----------------- Properties -----------------
+
+void CheckLocatePoint(const Polygon& polygon, std::mt19937& rng, TestStats& stats, int iteration) {
+    std::uniform_real_distribution<double> coord(-35.0, 35.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    PolygonCollection single;
+    single.Append(polygon);
+    PolygonView view = single.GetPolygon(0);
+
+    bool agree = true;
+    bool linearAgrees = true;
+    bool viewAgrees = true;
+    for (int k = 0; k < 200; ++k) {
+        Point q(coord(rng), coord(rng));
+        PointLocation fast = polygon.LocatePoint(q);
+        PointLocation linear = polygon.LocatePointLinear(q);
+        viewAgrees = viewAgrees && view.LocatePoint(q) == linear;
+        if (RefBoundaryDistance(polygon, q) < 1e-6) {
+            continue;
+        }
+        PointLocation expected = RefWinding(polygon, q) != 0 ? PointLocation::Inside
+                                                             : PointLocation::Outside;
+        agree = agree && fast == expected;
+        linearAgrees = linearAgrees && linear == expected;
+    }
+    Report("LocatePoint matches winding number", agree, stats, iteration);
+    Report("LocatePointLinear matches winding number", linearAgrees, stats, iteration);
+    Report("PolygonView::LocatePoint matches Polygon", viewAgrees, stats, iteration);
+
+    bool onEdge = true;
+    int n = polygon.GetNumPoints();
+    for (int k = 0; k < 20; ++k) {
+        int i = static_cast<int>(unit(rng) * n) % n;
+        const Point* a = polygon.GetPoint(i);
+        const Point* b = polygon.GetPoint((i + 1) % n);
+        double t = unit(rng);
+        Point q(a->GetX() + t * (b->GetX() - a->GetX()), a->GetY() + t * (b->GetY() - a->GetY()));
+        onEdge = onEdge && polygon.LocatePoint(q) == PointLocation::OnEdge;
+    }
+    Report("LocatePoint finds points on edges", onEdge, stats, iteration);
+}
+
+void CheckMetrics(const Polygon& polygon, bool convexByConstruction, TestStats& stats, int iteration) {
+    Report("Perimeter matches long double reference",
+           Close(polygon.Perimeter(), RefPerimeter(polygon), 1e-12), stats, iteration);
+    if (convexByConstruction) {
+        Report("IsConvex true on convex generator", polygon.IsConvex(), stats, iteration);
+    } else {
+        Report("IsConvex matches O(n^2) reference",
+               polygon.IsConvex() == RefIsConvex(polygon), stats, iteration);
+    }
+
+    PolygonCollection single;
+    single.Append(polygon);
+    PolygonView view = single.GetPolygon(0);
+    Report("PolygonView::Perimeter identical", view.Perimeter() == polygon.Perimeter(),
+           stats, iteration);
+    Report("PolygonView::IsConvex identical", view.IsConvex() == polygon.IsConvex(),
+           stats, iteration);
+}
+
+void CheckDistances(const Polygon& a, const Polygon& b, std::mt19937& rng,
+                    TestStats& stats, int iteration) {
+    std::uniform_real_distribution<double> coord(-35.0, 35.0);
+    bool boundary = true;
+    bool nearest = true;
+    for (int k = 0; k < 50; ++k) {
+        Point q(coord(rng), coord(rng));
+        double expected = RefBoundaryDistance(a, q);
+        boundary = boundary && Close(a.DistanceToBoundary(q), expected);
+        int edge = a.NearestEdge(q);
+        const Point* p0 = a.GetPoint(edge);
+        const Point* p1 = a.GetPoint((edge + 1) % a.GetNumPoints());
+        nearest = nearest && Close(RefSegmentDistance(q.GetX(), q.GetY(), p0->GetX(), p0->GetY(),
+                                                      p1->GetX(), p1->GetY()), expected);
+    }
+    Report("DistanceToBoundary matches brute force", boundary, stats, iteration);
+    Report("NearestEdge is a closest edge", nearest, stats, iteration);
+    Report("DistanceTo matches brute force",
+           Close(a.DistanceTo(b), RefPolygonDistance(a, b), 1e-7), stats, iteration);
+}
+
+void CheckRasterizer(const Polygon& polygon, TestStats& stats, int iteration) {
+    const int W = 70, H = 70;
+    Rasterizer raster(W, H, -35.0, -35.0, 1.0);
+    std::vector<unsigned char> mask(W * H, 0);
+    std::vector<unsigned char> threaded(W * H, 0);
+    raster.FillMask(polygon, mask.data());
+    raster.FillMask(polygon, threaded.data(), 3);
+
+    bool agree = true;
+    for (int row = 0; row < H; ++row) {
+        for (int col = 0; col < W; ++col) {
+            Point center(-35.0 + col + 0.5, -35.0 + row + 0.5);
+            if (RefBoundaryDistance(polygon, center) < 1e-6) {
+                continue;
+            }
+            bool inside = RefWinding(polygon, center) != 0;
+            agree = agree && inside == (mask[row * W + col] == 1);
+        }
+    }
+    Report("FillMask matches winding number", agree, stats, iteration);
+    Report("FillMask threaded identical", mask == threaded, stats, iteration);
+}
+
+void CheckMinkowskiAndOffset(const Polygon& a, const Polygon& b, std::mt19937& rng,
+                             TestStats& stats, int iteration) {
+    int n = a.GetNumPoints();
+    int m = b.GetNumPoints();
+    Polygon sum(n + m);
+    bool ok = a.MinkowskiSum(b, sum);
+    Report("MinkowskiSum accepts convex operands", ok, stats, iteration);
+    if (!ok) {
+        return;
+    }
+    Report("MinkowskiSum is convex", RefIsConvex(sum), stats, iteration);
+    Report("MinkowskiSum perimeter is the sum of perimeters",
+           Close(RefPerimeter(sum), RefPerimeter(a) + RefPerimeter(b), 1e-7), stats, iteration);
+
+    std::uniform_int_distribution<int> pickA(0, n - 1);
+    std::uniform_int_distribution<int> pickB(0, m - 1);
+    bool contains = true;
+    for (int k = 0; k < 20; ++k) {
+        const Point* p = a.GetPoint(pickA(rng));
+        const Point* q = b.GetPoint(pickB(rng));
+        Point corner(p->GetX() + q->GetX(), p->GetY() + q->GetY());
+        contains = contains && (RefWinding(sum, corner) != 0 ||
+                                RefBoundaryDistance(sum, corner) < 1e-7);
+    }
+    Report("MinkowskiSum contains vertex sums", contains, stats, iteration);
+
+    std::uniform_real_distribution<double> amount(0.1, 3.0);
+    double distance = amount(rng);
+    Polygon offset(n * 17);
+    ok = a.Offset(distance, JoinStyle::Round, offset);
+    bool exact = ok;
+    for (int i = 0; ok && i < offset.GetNumPoints(); ++i) {
+        const Point& p = *offset.GetPoint(i);
+        exact = exact && Close(RefBoundaryDistance(a, p), distance, 1e-7) &&
+                RefWinding(a, p) == 0;
+    }
+    Report("Offset round vertices lie at the offset distance", exact, stats, iteration);
+}
+
+void CheckTransforms(const std::vector<Polygon>& polygons, std::mt19937& rng,
+                     TestStats& stats, int iteration) {
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    AffineTransform transform(unit(rng), unit(rng), unit(rng), unit(rng),
+                              10.0 * unit(rng), 10.0 * unit(rng));
+
+    PolygonCollection collection;
+    for (const Polygon& polygon : polygons) {
+        collection.Append(polygon);
+    }
+    std::vector<BoundingBox> boxes(polygons.size());
+    collection.Transform(transform, boxes.data(), 3);
+
+    bool agree = true;
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        PolygonView view = collection.GetPolygon(static_cast<int>(i));
+        double minX = std::numeric_limits<double>::infinity();
+        double maxY = -std::numeric_limits<double>::infinity();
+        for (int k = 0; k < view.GetNumPoints(); ++k) {
+            Point expected = transform.Apply(*polygons[i].GetPoint(k));
+            agree = agree && view.GetPoint(k).Equals(expected);
+            minX = std::min(minX, expected.GetX());
+            maxY = std::max(maxY, expected.GetY());
+        }
+        agree = agree && boxes[i].minX == minX && boxes[i].maxY == maxY;
+    }
+    Report("Collection Transform matches per-point Apply", agree, stats, iteration);
+}
+
+void CheckLoaders(const std::vector<Polygon>& polygons, TestStats& stats, int iteration) {
+    std::ostringstream text;
+    text << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const Polygon& polygon : polygons) {
+        text << polygon.GetNumPoints() << "\n";
+        for (int k = 0; k < polygon.GetNumPoints(); ++k) {
+            text << polygon.GetPoint(k)->GetX() << "," << polygon.GetPoint(k)->GetY() << "\n";
+        }
+        text << (polygon.IsConvex() ? "Yes" : "No") << "\n"
+             << polygon.GetNumPoints() << "\n" << polygon.Perimeter() << "\n\n";
+    }
+
+    std::istringstream first(text.str());
+    PolygonCollection collection;
+    std::string error;
+    bool loaded = collection.LoadFromStream(first, error) == static_cast<long>(polygons.size());
+    for (size_t i = 0; loaded && i < polygons.size(); ++i) {
+        PolygonView view = collection.GetPolygon(static_cast<int>(i));
+        for (int k = 0; k < view.GetNumPoints(); ++k) {
+            loaded = loaded && view.GetPoint(k).Equals(*polygons[i].GetPoint(k));
+        }
+    }
+    Report("LoadFromStream round-trips exactly", loaded, stats, iteration);
+
+    std::istringstream second(text.str());
+    PolygonPipeline pipeline(3, 2, 64);
+    bool piped = true;
+    long count = pipeline.Run(second, [&](const PolygonRecord& record) {
+        const Polygon& original = polygons[record.index];
+        piped = piped && record.convex == original.IsConvex() &&
+                record.perimeter == original.Perimeter() &&
+                record.polygon->GetNumPoints() == original.GetNumPoints();
+    });
+    Report("Pipeline matches sequential metrics",
+           piped && count == static_cast<long>(polygons.size()), stats, iteration);
+}
+
+// ----------------- main -----------------
+
+int main(int argc, char* argv[]) {
+    int iterations = 200;
+    unsigned seed = 12345;
+    if (argc > 1) {
+        iterations = std::atoi(argv[1]);
+    }
+    if (argc > 2) {
+        seed = static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10));
+    }
+    std::cout << "Fuzzing " << iterations << " iterations with seed " << seed << "...\n";
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> smallSize(3, 24);
+    std::uniform_int_distribution<int> largeSize(100, 2000);
+    TestStats stats;
+
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        bool large = iteration % 10 == 9;
+        int n = large ? largeSize(rng) : smallSize(rng);
+
+        Polygon convex = RandomConvex(rng, n);
+        Polygon simple = RandomSimple(rng, n);
+        Polygon otherConvex = RandomConvex(rng, smallSize(rng));
+        Polygon otherSimple = RandomSimple(rng, smallSize(rng));
+        if (convex.GetNumPoints() < 3 || simple.GetNumPoints() < 3 ||
+            otherConvex.GetNumPoints() < 3 || otherSimple.GetNumPoints() < 3) {
+            continue; // duplicate angles collapsed a tiny polygon
+        }
+
+        CheckMetrics(convex, true, stats, iteration);
+        CheckMetrics(simple, false, stats, iteration);
+        CheckLocatePoint(convex, rng, stats, iteration);
+        CheckLocatePoint(simple, rng, stats, iteration);
+        CheckDistances(convex, otherConvex, rng, stats, iteration);
+        CheckDistances(simple, otherSimple, rng, stats, iteration);
+        CheckDistances(simple, otherConvex, rng, stats, iteration);
+        CheckDistances(WithRepeats(convex, rng), WithRepeats(otherConvex, rng), rng,
+                       stats, iteration);
+        if (!large) {
+            CheckRasterizer(simple, stats, iteration);
+        }
+
+        CheckMinkowskiAndOffset(convex, otherConvex, rng, stats, iteration);
+        CheckMinkowskiAndOffset(WithRepeats(convex, rng), WithRepeats(otherConvex, rng), rng,
+                                stats, iteration);
+
+        std::vector<Polygon> batch = {convex, simple, otherConvex, otherSimple};
+        CheckTransforms(batch, rng, stats, iteration);
+        CheckLoaders(batch, stats, iteration);
+    }
+
+    std::cout << "\n=== FUZZ SUMMARY ===\n";
+    std::cout << "Passed: " << stats.passed << "\n";
+    std::cout << "Failed: " << stats.failed << "\n";
+
+    if (stats.failed > 0) {
+        std::cout << "Some checks FAILED (seed " << seed << ").\n";
+        return 1;
+    }
+    std::cout << "All checks PASSED.\n";
+    return 0;
+}
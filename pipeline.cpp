@@ -0,0 +1,191 @@
+#include "pipeline.h"
+#include "spscqueue.h"
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const size_t CHUNK_QUEUE_CAPACITY = 4;
+
+// Joins every joinable thread when it goes out of scope, so no path out of
+// Run() leaves a running std::thread to terminate the program.
+class JoinGuard
+{
+private:
+    std::vector<std::thread>& _threads;
+
+public:
+    explicit JoinGuard(std::vector<std::thread>& threads) : _threads(threads) {}
+
+    ~JoinGuard()
+    {
+        for (std::thread& thread : _threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    JoinGuard(const JoinGuard&) = delete;
+    JoinGuard& operator=(const JoinGuard&) = delete;
+};
+
+} // namespace
+
+PolygonPipeline::PolygonPipeline(int workers, int queueCapacity, size_t chunkSize)
+    : _workers(workers), _queueCapacity(std::max(queueCapacity, 1)),
+      _chunkSize(std::max(chunkSize, static_cast<size_t>(1))), _error()
+{
+    if (_workers <= 0) {
+        // Reader, parser and writer take one hardware thread each.
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        _workers = std::max(hardware - 3, 1);
+    }
+}
+
+int PolygonPipeline::GetWorkers() const
+{
+    return _workers;
+}
+
+void PolygonPipeline::ComputeMetrics(PolygonRecord& record)
+{
+    record.convex = record.polygon->IsConvex();
+    record.perimeter = record.polygon->Perimeter();
+}
+
+long PolygonPipeline::Run(std::istream& in, const WriteFn& write)
+{
+    return Run(in, ComputeMetrics, write);
+}
+
+long PolygonPipeline::Run(std::istream& in, const MetricFn& metric, const WriteFn& write)
+{
+    _error.clear();
+
+    // A nullptr travelling down a queue marks the end of the stream.
+    SpscQueue<std::string*> chunks(CHUNK_QUEUE_CAPACITY);
+    std::vector<std::unique_ptr<SpscQueue<PolygonRecord*>>> toWorker;
+    std::vector<std::unique_ptr<SpscQueue<PolygonRecord*>>> fromWorker;
+    for (int k = 0; k < _workers; ++k) {
+        toWorker.emplace_back(new SpscQueue<PolygonRecord*>(_queueCapacity));
+        fromWorker.emplace_back(new SpscQueue<PolygonRecord*>(_queueCapacity));
+    }
+
+    // Each stage keeps the first exception it catches in its own slot and
+    // goes on forwarding the end-of-stream marker, so the other stages can
+    // finish and the exception is rethrown once every thread has stopped.
+    // Slot 0 is the reader, 1 the parser, 2 the writer, 3 + k worker k.
+    std::vector<std::exception_ptr> failures(3 + _workers);
+    std::string parseError;
+
+    std::vector<std::thread> threads;
+    threads.reserve(2 + _workers);
+    JoinGuard joinAll(threads);
+
+    threads.emplace_back([&]() {
+        try {
+            std::string* chunk = new std::string();
+            while (PolygonParser::ReadChunk(in, *chunk, _chunkSize)) {
+                chunks.Push(chunk);
+                chunk = new std::string();
+            }
+            delete chunk;
+        } catch (...) {
+            failures[0] = std::current_exception();
+        }
+        chunks.Push(nullptr);
+    });
+
+    threads.emplace_back([&]() {
+        PolygonParser textParser;
+        std::vector<PolygonRecord*> records;
+        long next = 0;
+        bool ok = true;
+        for (std::string* chunk = chunks.Pop(); chunk != nullptr; chunk = chunks.Pop()) {
+            // After an error keep draining so the reader can finish.
+            if (ok) {
+                try {
+                    ok = textParser.Feed(chunk->data(), chunk->size(), records);
+                } catch (...) {
+                    failures[1] = std::current_exception();
+                    ok = false;
+                }
+                for (PolygonRecord* record : records) {
+                    toWorker[next % _workers]->Push(record);
+                    ++next;
+                }
+                records.clear();
+            }
+            delete chunk;
+        }
+        if (ok && !textParser.Finish()) {
+            ok = false;
+        }
+        if (!ok) {
+            parseError = textParser.GetError();
+        }
+        for (int k = 0; k < _workers; ++k) {
+            toWorker[k]->Push(nullptr);
+        }
+    });
+
+    for (int k = 0; k < _workers; ++k) {
+        threads.emplace_back([&, k]() {
+            for (PolygonRecord* record = toWorker[k]->Pop(); record != nullptr;
+                 record = toWorker[k]->Pop()) {
+                if (!failures[3 + k]) {
+                    try {
+                        metric(*record);
+                    } catch (...) {
+                        failures[3 + k] = std::current_exception();
+                    }
+                }
+                fromWorker[k]->Push(record);
+            }
+            fromWorker[k]->Push(nullptr);
+        });
+    }
+
+    // Collect in the same rotation the parser dealt the records in. Once a
+    // write throws, the remaining records are only drained.
+    long collected = 0;
+    long written = 0;
+    for (PolygonRecord* record = fromWorker[0]->Pop(); record != nullptr;
+         record = fromWorker[collected % _workers]->Pop()) {
+        if (!failures[2]) {
+            try {
+                write(*record);
+                ++written;
+            } catch (...) {
+                failures[2] = std::current_exception();
+            }
+        }
+        delete record;
+        ++collected;
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& failure : failures) {
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    if (!parseError.empty()) {
+        _error = parseError;
+        return -1;
+    }
+    return written;
+}
+
+const std::string& PolygonPipeline::GetError() const
+{
+    return _error;
+}
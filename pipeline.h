@@ -0,0 +1,96 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+
+#include "polygonparser.h"
+
+/**
+ * @class PolygonPipeline
+ * @brief Concurrent reader, parser, metric and writer stages for polygon files.
+ *
+ * Run() drives four kinds of threads connected by bounded lock-free queues:
+ *
+ *   reader -> parser -> metric workers (N) -> writer
+ *
+ * The reader pulls fixed-size chunks from the stream, the parser turns them
+ * into PolygonRecord objects, the workers compute the metrics and the writer
+ * (the calling thread) hands each record to the caller. The parser deals
+ * records to the workers round-robin and the writer collects them in the same
+ * rotation, so results come out in input order without a reorder buffer.
+ * Since every queue is bounded, memory use does not grow with the input size.
+ *
+ * An exception thrown by the stream, the metric or the writer does not stop
+ * the other stages: the remaining records are drained, every thread is
+ * joined, and Run() then rethrows the first exception.
+ */
+class PolygonPipeline
+{
+public:
+    /// Computes the metrics of a record; runs on a worker thread.
+    typedef std::function<void(PolygonRecord&)> MetricFn;
+    /// Consumes a finished record; runs on the calling thread, in input order.
+    typedef std::function<void(const PolygonRecord&)> WriteFn;
+
+private:
+    int _workers;         ///< Number of metric worker threads.
+    int _queueCapacity;   ///< Capacity of each record queue.
+    size_t _chunkSize;    ///< Characters read from the stream per chunk.
+    std::string _error;   ///< Error of the last run, empty if none.
+
+public:
+    /**
+     * @brief Constructs a pipeline.
+     * @param workers The number of metric workers (0 picks one per spare hardware thread).
+     * @param queueCapacity The capacity of each record queue.
+     * @param chunkSize The number of characters read from the stream at a time.
+     */
+    PolygonPipeline(int workers = 0, int queueCapacity = 256, size_t chunkSize = 1 << 20);
+
+    /**
+     * @brief Gets the number of metric worker threads.
+     * @return The number of workers.
+     */
+    int GetWorkers() const;
+
+    /**
+     * @brief Computes the convexity and perimeter of a record.
+     * @param record The record to update.
+     */
+    static void ComputeMetrics(PolygonRecord& record);
+
+    /**
+     * @brief Processes a stream with ComputeMetrics() as the metric stage.
+     * @param in The stream to read.
+     * @param write Called for each record, in input order.
+     * @return The number of records written, or -1 if the input is malformed.
+     */
+    long Run(std::istream& in, const WriteFn& write);
+
+    /**
+     * @brief Processes a stream.
+     *
+     * Records are written up to the first malformed one; the error is then
+     * available from GetError().
+     *
+     * @param in The stream to read.
+     * @param metric Called for each record on a worker thread.
+     * @param write Called for each record, in input order, on the calling thread.
+     * @return The number of records written, or -1 if the input is malformed.
+     * @throws The first exception thrown by the stream, @p metric or @p write,
+     *         once all threads have stopped. No record is written after a
+     *         write throws.
+     */
+    long Run(std::istream& in, const MetricFn& metric, const WriteFn& write);
+
+    /**
+     * @brief Gets the error of the last run.
+     * @return The error message, or an empty string if the last run succeeded.
+     */
+    const std::string& GetError() const;
+};
+
+#endif // PIPELINE_H
@@ -1,13 +1,20 @@
 #include "polygon.h"
 #include "point.h"
+#include "edgebvh.h"
+#include "polygonalgorithms.h"
 
 #include <iostream>
 #include <sstream>
 #include <cmath>
 #include <string>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <vector>
 
 Polygon::Polygon(int capacity)
-    : _points(nullptr), _numPoints(0), _capacity(capacity)
+    : _points(nullptr), _numPoints(0), _capacity(capacity), _edgeIndex(nullptr),
+      _convexity(Convexity::Unknown)
 {
     _points = new Point*[_capacity];
     for (int i = 0; i < _capacity; ++i) {
@@ -17,16 +24,18 @@ Polygon::Polygon(int capacity)
 
 Polygon::~Polygon()
 {
-    // Delete individual points
-    for (int i = 0; i < _numPoints; ++i) {
+    // Delete individual points, including those kept for reuse by Clear()
+    for (int i = 0; i < _capacity; ++i) {
         delete _points[i];
     }
     // Delete the array of pointers
     delete[] _points;
+    delete _edgeIndex.load(std::memory_order_acquire);
 }
 
 Polygon::Polygon(const Polygon& other)
-    : _points(nullptr), _numPoints(other._numPoints), _capacity(other._capacity)
+    : _points(nullptr), _numPoints(other._numPoints), _capacity(other._capacity),
+      _edgeIndex(nullptr), _convexity(other._convexity.load(std::memory_order_relaxed))
 {
     _points = new Point*[_capacity];
     for (int i = 0; i < _capacity; ++i) {
@@ -44,10 +53,11 @@ Polygon& Polygon::operator=(const Polygon& other)
     }
 
     // Free existing resources
-    for (int i = 0; i < _numPoints; ++i) {
+    for (int i = 0; i < _capacity; ++i) {
         delete _points[i];
     }
     delete[] _points;
+    InvalidateCaches();
 
     // Copy size/capacity
     _capacity = other._capacity;
@@ -63,37 +73,44 @@ Polygon& Polygon::operator=(const Polygon& other)
     for (int i = 0; i < _numPoints; ++i) {
         _points[i] = new Point(*other._points[i]);
     }
+    _convexity.store(other._convexity.load(std::memory_order_relaxed),
+                     std::memory_order_relaxed);
 
     return *this;
 }
 
 bool Polygon::IsConvex() const
 {
-    if (_numPoints < 3) return false;
+    Convexity convexity = GetConvexity();
+    return convexity != Convexity::NotConvex;
+}
 
-    bool positive = false;
-    bool negative = false;
-    const double EPS = 1e-9;
+namespace {
 
-    for (int i = 0; i < _numPoints; ++i) {
-        const Point& p1 = *_points[i];
-        const Point& p2 = *_points[(i + 1) % _numPoints];
-        const Point& p3 = *_points[(i + 2) % _numPoints];
+// Coordinate accessor for the shared algorithms in polygonalgorithms.h.
+class PointCoords
+{
+private:
+    Point* const* _points;
+    int _numPoints;
 
-        double cross =
-            (p2.GetX() - p1.GetX()) * (p3.GetY() - p2.GetY()) -
-            (p2.GetY() - p1.GetY()) * (p3.GetX() - p2.GetX());
+public:
+    PointCoords(Point* const* points, int numPoints) : _points(points), _numPoints(numPoints) {}
+    int Size() const { return _numPoints; }
+    double X(int i) const { return _points[i]->GetX(); }
+    double Y(int i) const { return _points[i]->GetY(); }
+};
 
-        if (cross > EPS) positive = true;
-        if (cross < -EPS) negative = true;
+} // namespace
 
-        if (positive && negative) {
-            return false; // Found both left and right turns
-        }
+Convexity Polygon::GetConvexity() const
+{
+    Convexity convexity = _convexity.load(std::memory_order_relaxed);
+    if (convexity == Convexity::Unknown) {
+        convexity = ClassifyConvexity(PointCoords(_points, _numPoints));
+        _convexity.store(convexity, std::memory_order_relaxed);
     }
-
-    // If all turns are collinear, you can decide if that counts as convex.
-    return positive || negative; // false if all points are collinear
+    return convexity;
 }
 
 int Polygon::GetNumPoints() const
@@ -114,21 +131,103 @@ bool Polygon::SetPoint(int index, const Point& point)
     if (index < 0 || index >= _numPoints) {
         return false;
     }
-    delete _points[index];
-    _points[index] = new Point(point);
+    _points[index]->SetX(point.GetX());
+    _points[index]->SetY(point.GetY());
+    InvalidateCaches();
     return true;
 }
 
+void Polygon::Transform(const AffineTransform& transform, BoundingBox* box)
+{
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = std::numeric_limits<double>::infinity();
+    double maxX = -std::numeric_limits<double>::infinity();
+    double maxY = -std::numeric_limits<double>::infinity();
+
+    for (int i = 0; i < _numPoints; ++i) {
+        Point* p = _points[i];
+        Point moved = transform.Apply(*p);
+        p->SetX(moved.GetX());
+        p->SetY(moved.GetY());
+        minX = std::min(minX, moved.GetX());
+        minY = std::min(minY, moved.GetY());
+        maxX = std::max(maxX, moved.GetX());
+        maxY = std::max(maxY, moved.GetY());
+    }
+
+    if (box != nullptr) {
+        box->minX = minX;
+        box->minY = minY;
+        box->maxX = maxX;
+        box->maxY = maxY;
+    }
+    InvalidateCaches();
+}
+
+void Polygon::TransformAll(Polygon* polygons, int count, const AffineTransform& transform,
+                           BoundingBox* boxes, int threads)
+{
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::clamp(threads, 1, std::max(count, 1));
+
+    auto work = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            polygons[i].Transform(transform, boxes != nullptr ? &boxes[i] : nullptr);
+        }
+    };
+    if (threads == 1) {
+        work(0, count);
+        return;
+    }
+
+    // Cut the array into ranges holding about the same number of points.
+    long total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += polygons[i].GetNumPoints();
+    }
+    std::vector<std::thread> pool;
+    int begin = 0;
+    long seen = 0;
+    for (int t = 1; t <= threads && begin < count; ++t) {
+        long target = total * t / threads;
+        int end = begin;
+        while (end < count && (seen < target || end == begin || t == threads)) {
+            seen += polygons[end].GetNumPoints();
+            ++end;
+        }
+        pool.emplace_back(work, begin, end);
+        begin = end;
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
 bool Polygon::AddPoint(const Point& point)
 {
     if (_numPoints >= _capacity) {
         return false;
     }
-    _points[_numPoints] = new Point(point);
+    // Reuse a point left behind by Clear() when there is one
+    if (_points[_numPoints] != nullptr) {
+        _points[_numPoints]->SetX(point.GetX());
+        _points[_numPoints]->SetY(point.GetY());
+    } else {
+        _points[_numPoints] = new Point(point);
+    }
     ++_numPoints;
+    InvalidateCaches();
     return true;
 }
 
+void Polygon::Clear()
+{
+    _numPoints = 0;
+    InvalidateCaches();
+}
+
 double Polygon::Perimeter() const
 {
     if (_numPoints < 2) {
@@ -157,9 +256,499 @@ std::string Polygon::ToString() const
     return oss.str();
 }
 
-PointLocation Polygon::LocatePoint(const Point& point) const{
-    return PointLocation::Invalid;
+PointLocation Polygon::LocatePoint(const Point& point) const
+{
+    if (_numPoints < 3) {
+        return PointLocation::Invalid;
+    }
+
+    PointCoords coords(_points, _numPoints);
+    switch (GetConvexity()) {
+    case Convexity::Counterclockwise:
+        return LocatePointConvex(coords, point.GetX(), point.GetY(), 1);
+    case Convexity::Clockwise:
+        return LocatePointConvex(coords, point.GetX(), point.GetY(), -1);
+    default:
+        return ::LocatePointLinear(coords, point.GetX(), point.GetY());
+    }
+}
+
+PointLocation Polygon::LocatePointLinear(const Point& point) const
+{
+    return ::LocatePointLinear(PointCoords(_points, _numPoints), point.GetX(), point.GetY());
+}
+
+const EdgeBVH& Polygon::EdgeIndex() const
+{
+    EdgeBVH* index = _edgeIndex.load(std::memory_order_acquire);
+    if (index == nullptr) {
+        // Publish with a CAS; a thread that loses the race uses the winner's.
+        EdgeBVH* built = new EdgeBVH(*this);
+        if (_edgeIndex.compare_exchange_strong(index, built, std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+            index = built;
+        } else {
+            delete built;
+        }
+    }
+    return *index;
+}
+
+void Polygon::InvalidateCaches()
+{
+    delete _edgeIndex.exchange(nullptr, std::memory_order_acq_rel);
+    _convexity.store(Convexity::Unknown, std::memory_order_relaxed);
+}
+
+double Polygon::DistanceToBoundary(const Point& point) const
+{
+    if (_numPoints == 0) {
+        return -1.0;
+    }
+    double distance = 0.0;
+    EdgeIndex().Nearest(point.GetX(), point.GetY(), distance);
+    return distance;
+}
+
+int Polygon::NearestEdge(const Point& point) const
+{
+    if (_numPoints == 0) {
+        return -1;
+    }
+    double distance = 0.0;
+    return EdgeIndex().Nearest(point.GetX(), point.GetY(), distance);
+}
+
+namespace {
+
+struct Vec2 {
+    double x;
+    double y;
+};
+
+double Dot(const Vec2& a, const Vec2& b)
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+double Cross(const Vec2& a, const Vec2& b)
+{
+    return a.x * b.y - a.y * b.x;
 }
+
+// Vertex of a convex polygon farthest along the direction (dx, dy), found in
+// O(log n). Walking the polygon counterclockwise (mirrored in y when the
+// orientation is -1), edge directions turn monotonically through one full
+// turn starting from edge 0; the farthest vertex starts the first edge that
+// has turned past the perpendicular (-dy, dx), so a binary search finds it.
+Vec2 Support(const Polygon& polygon, int orientation, double dx, double dy)
+{
+    const int n = polygon.GetNumPoints();
+    auto vertex = [&](int i) {
+        const Point* p = polygon.GetPoint(i);
+        return Vec2{p->GetX(), orientation * p->GetY()};
+    };
+    auto same = [](const Vec2& a, const Vec2& b) {
+        return a.x == b.x && a.y == b.y;
+    };
+    // Direction of edge k, skipping copies of its start vertex.
+    auto edge = [&](int k) {
+        Vec2 a = vertex(k);
+        for (int step = 1; step < n; ++step) {
+            Vec2 b = vertex((k + step) % n);
+            if (!same(a, b)) {
+                return Vec2{b.x - a.x, b.y - a.y};
+            }
+        }
+        return Vec2{0.0, 0.0};
+    };
+
+    // Copies of vertex 0 at the end (a closed ring) would repeat edge 0 after
+    // the full turn, so the search stops before them.
+    const Vec2 v0 = vertex(0);
+    int count = n;
+    while (count > 1 && same(vertex(count - 1), v0)) {
+        --count;
+    }
+
+    const Vec2 direction{dx, orientation * dy};
+    const Vec2 e0 = edge(0);
+    const double e0Length = std::sqrt(Dot(e0, e0));
+    // Angles measured from edge 0: half 0 is [0, pi), half 1 is [pi, 2 pi).
+    // Edges parallel to edge 0 within the IsConvex() tolerance are either a
+    // slight wobble at the start of the walk or the last turn before closing,
+    // so their position in the walk decides which end of the range they are.
+    auto half = [&](const Vec2& v, int k) {
+        double c = Cross(e0, v);
+        if (Dot(e0, v) > 0.0 && std::fabs(c) <= 1e-9 * e0Length * std::sqrt(Dot(v, v))) {
+            return 2 * k < count ? 0 : 1;
+        }
+        return c > 0.0 ? 0 : 1;
+    };
+    const Vec2 target{-direction.y, direction.x};
+    const int targetHalf = half(target, 0);
+    auto beforeTarget = [&](int k) {
+        Vec2 v = edge(k);
+        int hv = half(v, k);
+        return hv != targetHalf ? hv < targetHalf : Cross(v, target) > 0.0;
+    };
+
+    int best = 0;
+    if (e0.x != 0.0 || e0.y != 0.0) {
+        int low = 0;
+        int high = count;
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (beforeTarget(middle)) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        best = low % count;
+    }
+
+    // Turns within the IsConvex() tolerance can bend the order slightly;
+    // climb to the local maximum, which on a convex polygon is global.
+    // Neighbours with an equal product (repeated vertices, or an edge
+    // perpendicular to the direction) are crossed rather than stopped at.
+    double bestDot = Dot(vertex(best), direction);
+    for (int step : {1, n - 1}) {
+        int at = best;
+        for (int moves = 1; moves < n; ++moves) {
+            at = (at + step) % n;
+            double d = Dot(vertex(at), direction);
+            if (d < bestDot) {
+                break;
+            }
+            if (d > bestDot) {
+                best = at;
+                bestDot = d;
+            }
+        }
+    }
+    const Point* p = polygon.GetPoint(best);
+    return Vec2{p->GetX(), p->GetY()};
+}
+
+// Closest point to the origin on the segment a-b.
+Vec2 ClosestOnSegment(const Vec2& a, const Vec2& b, double& t)
+{
+    Vec2 ab{b.x - a.x, b.y - a.y};
+    double lenSq = Dot(ab, ab);
+    t = (lenSq > 0.0) ? std::clamp(-Dot(a, ab) / lenSq, 0.0, 1.0) : 0.0;
+    return Vec2{a.x + t * ab.x, a.y + t * ab.y};
+}
+
+// Replaces the simplex by its smallest sub-simplex that holds the point
+// closest to the origin, and returns that point. A triangle is kept only
+// when it encloses the origin.
+Vec2 ReduceSimplex(Vec2* simplex, int& count)
+{
+    if (count == 1) {
+        return simplex[0];
+    }
+
+    if (count == 2) {
+        double t;
+        Vec2 v = ClosestOnSegment(simplex[0], simplex[1], t);
+        if (t <= 0.0) {
+            count = 1;
+        } else if (t >= 1.0) {
+            simplex[0] = simplex[1];
+            count = 1;
+        }
+        return v;
+    }
+
+    const Vec2& a = simplex[0];
+    const Vec2& b = simplex[1];
+    const Vec2& c = simplex[2];
+    double c1 = a.x * b.y - a.y * b.x;
+    double c2 = b.x * c.y - b.y * c.x;
+    double c3 = c.x * a.y - c.y * a.x;
+    if ((c1 >= 0 && c2 >= 0 && c3 >= 0) || (c1 <= 0 && c2 <= 0 && c3 <= 0)) {
+        return Vec2{0.0, 0.0};
+    }
+
+    // Outside the triangle: keep whichever edge is closest.
+    Vec2 best{0.0, 0.0};
+    double bestSq = -1.0;
+    int keepA = 0, keepB = 1;
+    const int pairs[3][2] = {{0, 1}, {1, 2}, {2, 0}};
+    for (const auto& pair : pairs) {
+        double t;
+        Vec2 v = ClosestOnSegment(simplex[pair[0]], simplex[pair[1]], t);
+        double d = Dot(v, v);
+        if (bestSq < 0.0 || d < bestSq) {
+            bestSq = d;
+            best = v;
+            keepA = pair[0];
+            keepB = pair[1];
+        }
+    }
+    Vec2 va = simplex[keepA];
+    Vec2 vb = simplex[keepB];
+    simplex[0] = va;
+    simplex[1] = vb;
+    count = 2;
+    return ReduceSimplex(simplex, count);
+}
+
+// Distance between two convex polygons with GJK on the Minkowski difference
+// a - b: the distance is the norm of the difference point closest to the
+// origin, and 0 when the origin lies inside the difference.
+double ConvexDistance(const Polygon& a, int orientationA, const Polygon& b, int orientationB)
+{
+    const double REL_EPS = 1e-12;
+    Vec2 simplex[3];
+    int count = 1;
+    const Point* pa = a.GetPoint(0);
+    const Point* pb = b.GetPoint(0);
+    simplex[0] = Vec2{pa->GetX() - pb->GetX(), pa->GetY() - pb->GetY()};
+    Vec2 v = simplex[0];
+
+    int maxIterations = a.GetNumPoints() + b.GetNumPoints() + 8;
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        double vv = Dot(v, v);
+        if (vv == 0.0) {
+            return 0.0;
+        }
+        Vec2 sa = Support(a, orientationA, -v.x, -v.y);
+        Vec2 sb = Support(b, orientationB, v.x, v.y);
+        Vec2 w{sa.x - sb.x, sa.y - sb.y};
+        // No support point gets meaningfully closer: v is the answer.
+        if (vv - Dot(v, w) <= REL_EPS * vv) {
+            return std::sqrt(vv);
+        }
+        simplex[count++] = w;
+        v = ReduceSimplex(simplex, count);
+        if (count == 3) {
+            return 0.0;
+        }
+    }
+    return std::sqrt(Dot(v, v));
+}
+
+} // namespace
+
+double Polygon::DistanceTo(const Polygon& other) const
+{
+    if (_numPoints == 0 || other._numPoints == 0) {
+        return -1.0;
+    }
+
+    auto orientation = [](Convexity convexity) {
+        return convexity == Convexity::Counterclockwise ? 1
+             : convexity == Convexity::Clockwise ? -1 : 0;
+    };
+    int orientationA = orientation(GetConvexity());
+    int orientationB = orientation(other.GetConvexity());
+    if (orientationA != 0 && orientationB != 0) {
+        return ConvexDistance(*this, orientationA, other, orientationB);
+    }
+
+    double distance = EdgeIndex().Distance(other.EdgeIndex());
+    if (distance == 0.0) {
+        return 0.0;
+    }
+    // The boundaries do not meet, so either one polygon holds the other
+    // entirely or they are disjoint; a single vertex tells which.
+    if (other.LocatePoint(*_points[0]) == PointLocation::Inside ||
+        LocatePoint(*other._points[0]) == PointLocation::Inside) {
+        return 0.0;
+    }
+    return distance;
+}
+
+namespace {
+
+// Twice the signed area: positive for counterclockwise polygons.
+double TwiceSignedArea(const Polygon& polygon)
+{
+    int n = polygon.GetNumPoints();
+    double sum = 0.0;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        const Point* a = polygon.GetPoint(j);
+        const Point* b = polygon.GetPoint(i);
+        sum += a->GetX() * b->GetY() - b->GetX() * a->GetY();
+    }
+    return sum;
+}
+
+// Walks a polygon counterclockwise starting at its lowest (then leftmost) point.
+class CcwWalk
+{
+private:
+    const Polygon& _polygon;
+    int _n;
+    int _start;
+    int _step;
+
+public:
+    explicit CcwWalk(const Polygon& polygon)
+        : _polygon(polygon), _n(polygon.GetNumPoints()), _start(0),
+          _step(TwiceSignedArea(polygon) >= 0.0 ? 1 : -1)
+    {
+        for (int i = 1; i < _n; ++i) {
+            const Point* p = polygon.GetPoint(i);
+            const Point* best = polygon.GetPoint(_start);
+            if (p->GetY() < best->GetY() ||
+                (p->GetY() == best->GetY() && p->GetX() < best->GetX())) {
+                _start = i;
+            }
+        }
+    }
+
+    const Point& operator[](int k) const
+    {
+        int index = ((_start + _step * k) % _n + _n) % _n;
+        return *_polygon.GetPoint(index);
+    }
+};
+
+} // namespace
+
+bool Polygon::MinkowskiSum(const Polygon& other, Polygon& result) const
+{
+    if (&result == this || &result == &other) {
+        return false;
+    }
+    // The edge merge needs edges that turn through exactly one full turn;
+    // IsConvex() also accepts sequences that wind around more than once.
+    auto convex = [](Convexity c) {
+        return c == Convexity::Counterclockwise || c == Convexity::Clockwise;
+    };
+    if (!convex(GetConvexity()) || !convex(other.GetConvexity())) {
+        return false;
+    }
+    int n = _numPoints;
+    int m = other._numPoints;
+    if (result._capacity < n + m) {
+        return false;
+    }
+
+    result.Clear();
+    CcwWalk a(*this);
+    CcwWalk b(other);
+    int i = 0;
+    int j = 0;
+    while (true) {
+        // Repeated vertices (a closed ring repeats its first one) give
+        // zero-length edges with no direction; each operand skips its own.
+        while (i < n && a[i + 1].Equals(a[i])) {
+            ++i;
+        }
+        while (j < m && b[j + 1].Equals(b[j])) {
+            ++j;
+        }
+        if (i >= n && j >= m) {
+            break;
+        }
+        if (!result.AddPoint(Point(a[i].GetX() + b[j].GetX(), a[i].GetY() + b[j].GetY()))) {
+            return false;
+        }
+        // Advance along whichever edge turns less; both when they are parallel.
+        // An operand whose edges are used up waits for the other one.
+        double ex = a[i + 1].GetX() - a[i].GetX();
+        double ey = a[i + 1].GetY() - a[i].GetY();
+        double fx = b[j + 1].GetX() - b[j].GetX();
+        double fy = b[j + 1].GetY() - b[j].GetY();
+        double cross = ex * fy - ey * fx;
+        int before = i + j;
+        bool advanceA = i < n && (j >= m || cross >= 0.0);
+        bool advanceB = j < m && (i >= n || cross <= 0.0);
+        i += advanceA ? 1 : 0;
+        j += advanceB ? 1 : 0;
+        if (i + j == before) {
+            return false; // only NaN coordinates leave the edges unordered
+        }
+    }
+    return true;
+}
+
+bool Polygon::Offset(double distance, JoinStyle join, Polygon& result,
+                     int arcSegments, double miterLimit) const
+{
+    if (&result == this || _numPoints < 3) {
+        return false;
+    }
+    double area = TwiceSignedArea(*this);
+    if (area == 0.0) {
+        return false;
+    }
+    // Outward normal of edge (dx, dy) is (dy, -dx) for counterclockwise
+    // polygons and (-dy, dx) for clockwise ones.
+    const double orient = (area > 0.0) ? 1.0 : -1.0;
+    arcSegments = std::max(arcSegments, 1);
+
+    result.Clear();
+    for (int i = 0; i < _numPoints; ++i) {
+        const Point& v = *_points[i];
+        // Neighbours, skipping duplicates of v.
+        int prev = (i + _numPoints - 1) % _numPoints;
+        while (prev != i && _points[prev]->Equals(v)) {
+            prev = (prev + _numPoints - 1) % _numPoints;
+        }
+        int next = (i + 1) % _numPoints;
+        while (next != i && _points[next]->Equals(v)) {
+            next = (next + 1) % _numPoints;
+        }
+        if (prev == i || next == i) {
+            return false;
+        }
+        // Emit each run of duplicates only once, at its last point.
+        if (_points[(i + 1) % _numPoints]->Equals(v)) {
+            continue;
+        }
+
+        double ax = v.GetX() - _points[prev]->GetX();
+        double ay = v.GetY() - _points[prev]->GetY();
+        double bx = _points[next]->GetX() - v.GetX();
+        double by = _points[next]->GetY() - v.GetY();
+        double la = std::sqrt(ax * ax + ay * ay);
+        double lb = std::sqrt(bx * bx + by * by);
+        double n1x = orient * ay / la, n1y = -orient * ax / la;
+        double n2x = orient * by / lb, n2y = -orient * bx / lb;
+
+        double turn = orient * (ax * by - ay * bx); // > 0 at convex corners
+        double cosine = n1x * n2x + n1y * n2y;
+        bool gap = distance * turn > 0.0;
+
+        if (gap && join == JoinStyle::Round) {
+            double angle = std::acos(std::clamp(cosine, -1.0, 1.0));
+            int steps = std::max(1, static_cast<int>(std::ceil(angle / (M_PI / 2.0) * arcSegments)));
+            double start = std::atan2(n1y, n1x);
+            double sweep = (distance > 0.0 ? orient : -orient) * angle;
+            for (int k = 0; k <= steps; ++k) {
+                double t = start + sweep * k / steps;
+                Point p(v.GetX() + distance * std::cos(t), v.GetY() + distance * std::sin(t));
+                if (!result.AddPoint(p)) {
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        // Miter point: where the two moved edges meet.
+        double scale = (1.0 + cosine > 1e-12) ? distance / (1.0 + cosine) : 0.0;
+        bool bevel = (1.0 + cosine <= 1e-12) ||
+                     (gap && std::sqrt(2.0 / (1.0 + cosine)) > miterLimit);
+        if (bevel) {
+            if (!result.AddPoint(Point(v.GetX() + distance * n1x, v.GetY() + distance * n1y)) ||
+                !result.AddPoint(Point(v.GetX() + distance * n2x, v.GetY() + distance * n2y))) {
+                return false;
+            }
+            continue;
+        }
+        if (!result.AddPoint(Point(v.GetX() + scale * (n1x + n2x),
+                                   v.GetY() + scale * (n1y + n2y)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Polygon::ExportToSVG(const string& filename, int width, int height) const{
     return false;
 }
\ No newline at end of file
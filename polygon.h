@@ -1,9 +1,14 @@
 #ifndef POLYGON_H
 #define POLYGON_H
 
+#include <atomic>
 #include <string>
 #include "point.h"
+#include "affine.h"
 using std::string;
+
+class EdgeBVH;
+
 enum class PointLocation
 {
     Invalid = -1,
@@ -12,12 +17,40 @@ enum class PointLocation
     OnEdge
 };
 
+/// How Polygon::Offset() fills the gap between two offset edges at a corner.
+enum class JoinStyle
+{
+    Miter, ///< Extend both edges until they meet (bevelled past the miter limit).
+    Round  ///< Connect them with a circular arc around the corner.
+};
+
+/**
+ * @brief Shape of a point sequence as seen by Polygon::IsConvex() and LocatePoint().
+ *
+ * Wound marks sequences whose turns all go the same way but that wind around
+ * more than once (a pentagram, for example): IsConvex() accepts them, but
+ * they are not convex polygons.
+ */
+enum class Convexity
+{
+    Unknown,          ///< Not classified yet (only used by caches).
+    NotConvex,        ///< Turns both ways, or all points collinear.
+    Counterclockwise, ///< Convex, counterclockwise.
+    Clockwise,        ///< Convex, clockwise.
+    Wound             ///< Turns one way but winds around more than once.
+};
+
 /**
  * @class Polygon
  * @brief Represents a simple polygon in 2D as an ordered sequence of points.
  *
  * The polygon owns its points and stores them as pointers in a dynamic array.
  * The first @c _numPoints entries in the internal array are assumed to be valid.
+ * Entries past them are either nullptr or points kept by Clear() for reuse.
+ *
+ * Some const queries fill caches (the convexity and the edge hierarchy) on
+ * first use. The caches are atomic, so any number of threads may query the
+ * same polygon at once; modifying it while others read it is still a race.
  */
 class Polygon
 {
@@ -25,6 +58,31 @@ private:
     Point** _points;   ///< Array of pointers to points (owned by the polygon).
     int _numPoints;    ///< Current number of points stored in the polygon.
     int _capacity;     ///< Maximum number of points the polygon can hold.
+    mutable std::atomic<EdgeBVH*> _edgeIndex;    ///< Lazily built edge hierarchy (nullptr until needed).
+    mutable std::atomic<Convexity> _convexity;   ///< Cached shape (Unknown until needed).
+
+    /**
+     * @brief Returns the edge hierarchy, building it on first use.
+     *
+     * The hierarchy is cached until the polygon is modified. Threads that
+     * race to build it each build one, and all but the first to publish
+     * theirs discard it.
+     */
+    const EdgeBVH& EdgeIndex() const;
+
+    /**
+     * @brief Returns the shape of the point sequence, classifying it on first use.
+     *
+     * The result is cached until the polygon is modified. The cache uses
+     * relaxed atomics: a racing thread at worst classifies the points again
+     * and stores the same value.
+     */
+    Convexity GetConvexity() const;
+
+    /**
+     * @brief Discards cached data derived from the points.
+     */
+    void InvalidateCaches();
 
 public:
     /**
@@ -61,7 +119,8 @@ public:
      * The polygon is assumed to be simple and its vertices are assumed to be in
      * order (clockwise or counterclockwise). The method examines the signed
      * cross products of consecutive edges and returns true if all turns are in
-     * the same direction (or collinear).
+     * the same direction (or collinear). Zero-length edges from repeated
+     * points are skipped. The answer is cached until the polygon is modified.
      *
      * @return true if the polygon is convex, false otherwise.
      */
@@ -84,7 +143,8 @@ public:
     /**
      * @brief Sets (replaces) the point at the given index.
      *
-     * The existing point at @p index is deleted and replaced with a copy of @p point.
+     * The coordinates of @p point are copied into the existing point at
+     * @p index, so no memory is allocated or freed.
      *
      * @param index The index at which to set the point (must be in [0, GetNumPoints())).
      * @param point The point to store at the given index.
@@ -92,6 +152,33 @@ public:
      */
     bool SetPoint(int index, const Point& point);
 
+    /**
+     * @brief Applies an affine transform to every point, in place.
+     *
+     * The existing points are updated, so no memory is allocated. When @p box
+     * is given, the bounding box of the transformed polygon is computed in the
+     * same pass.
+     *
+     * @param transform The transform to apply.
+     * @param box Receives the bounding box of the transformed points (may be nullptr).
+     */
+    void Transform(const AffineTransform& transform, BoundingBox* box = nullptr);
+
+    /**
+     * @brief Applies an affine transform to an array of polygons, in place.
+     *
+     * The polygons are split into contiguous ranges of about the same number
+     * of points, one per thread.
+     *
+     * @param polygons The polygons to transform.
+     * @param count The number of polygons.
+     * @param transform The transform to apply.
+     * @param boxes Receives one bounding box per polygon (may be nullptr).
+     * @param threads The number of threads to use (0 for all hardware threads).
+     */
+    static void TransformAll(Polygon* polygons, int count, const AffineTransform& transform,
+                             BoundingBox* boxes = nullptr, int threads = 1);
+
     /**
      * @brief Adds a new point at the end of the polygon.
      *
@@ -102,6 +189,61 @@ public:
      */
     bool AddPoint(const Point& point);
 
+    /**
+     * @brief Removes every point without freeing it.
+     *
+     * Later calls to AddPoint() reuse the removed points, so refilling the
+     * polygon up to its previous size allocates no memory.
+     */
+    void Clear();
+
+    /**
+     * @brief Computes the Minkowski sum of this convex polygon and another one.
+     *
+     * The edges of both polygons are merged by angle starting from their
+     * lowest vertices, which takes O(n + m) time. Parallel edges are merged
+     * into one. The result is written counterclockwise into @p result, which
+     * is cleared first; it must not be either operand.
+     *
+     * @param other The other convex polygon.
+     * @param result Receives the sum; it needs a capacity of at least
+     *        GetNumPoints() + other.GetNumPoints().
+     * @return true on success, false if either polygon is not convex (point
+     *         sequences that wind around more than once are rejected even
+     *         though IsConvex() accepts them), if @p result is too small, or
+     *         if @p result is an operand.
+     */
+    bool MinkowskiSum(const Polygon& other, Polygon& result) const;
+
+    /**
+     * @brief Offsets (buffers) the polygon by a distance.
+     *
+     * Every edge is moved outwards by @p distance (inwards when negative) and
+     * consecutive moved edges are joined at each corner. Where they overlap
+     * the corner is the intersection of the two moved edges; where they leave
+     * a gap it is filled according to @p join. Miter corners longer than
+     * @p miterLimit times @p distance are bevelled. Consecutive duplicate
+     * points are skipped. The result keeps the orientation of the polygon.
+     *
+     * For a convex polygon and a positive distance the result is the exact
+     * offset curve (up to the arc approximation). For concave polygons, or
+     * insets larger than local feature size, the raw offset curve may
+     * self-intersect and is not cleaned up.
+     *
+     * @param distance The offset distance.
+     * @param join The corner style.
+     * @param result Receives the offset polygon and is cleared first; it must
+     *        not be this polygon. Miter joins need a capacity of
+     *        2 * GetNumPoints(); round joins need
+     *        GetNumPoints() * (2 * arcSegments + 1).
+     * @param arcSegments The number of segments per quarter turn of a round join.
+     * @param miterLimit The longest allowed miter, as a multiple of @p distance.
+     * @return true on success, false if the polygon has fewer than 3 distinct
+     *         points or @p result is too small.
+     */
+    bool Offset(double distance, JoinStyle join, Polygon& result,
+                int arcSegments = 8, double miterLimit = 2.0) const;
+
     /**
      * @brief Computes the perimeter of the polygon.
      *
@@ -125,14 +267,80 @@ public:
     /**
      * @brief Determines the location of a point relative to the polygon.
      *
-     * In here you will describe the algorithm you used to implement this method.
+     * Convex polygons (see IsConvex(), cached) are handled in O(log n): a
+     * binary search over the fan of diagonals from the first vertex finds the
+     * wedge containing the point, and only the edge closing that wedge and its
+     * two neighbours are tested. Other polygons, and points within 1e-9 of
+     * the lines along the edges at the first vertex (where collinear vertices
+     * leave empty wedges), use LocatePointLinear().
+     * Points farther than 1e-9 from the boundary get the same answer either way.
      *
      * @param point The point to test.
      * @return PointLocation::Inside if the point is inside the polygon,
-     *         PointLocation::Outside if outside, and
-     *         PointLocation::OnEdge if on the edge.
+     *         PointLocation::Outside if outside,
+     *         PointLocation::OnEdge if on the edge, and
+     *         PointLocation::Invalid if the polygon has fewer than 3 points.
      */
     PointLocation LocatePoint(const Point& point) const;
+
+    /**
+     * @brief Determines the location of a point by testing every edge.
+     *
+     * Each edge is first checked for the point lying on it (within a distance
+     * of 1e-9). Otherwise a horizontal ray is cast from the point towards +x
+     * and the edges it crosses are counted: an odd count means the point is
+     * inside. An edge counts when it straddles the ray's y-coordinate, with
+     * the lower endpoint included and the upper one excluded, so a ray through
+     * a vertex is counted exactly once.
+     *
+     * @param point The point to test.
+     * @return PointLocation::Inside if the point is inside the polygon,
+     *         PointLocation::Outside if outside,
+     *         PointLocation::OnEdge if on the edge, and
+     *         PointLocation::Invalid if the polygon has fewer than 3 points.
+     */
+    PointLocation LocatePointLinear(const Point& point) const;
+
+    /**
+     * @brief Computes the distance from a point to the polygon's boundary.
+     *
+     * Uses the cached edge hierarchy, so repeated queries against a large
+     * polygon only visit the edges near the point.
+     *
+     * @param point The query point.
+     * @return The distance to the closest edge, -1.0 if the polygon has no
+     *         points, or NaN if a coordinate of the point is NaN.
+     */
+    double DistanceToBoundary(const Point& point) const;
+
+    /**
+     * @brief Finds the edge closest to a point.
+     *
+     * Edge @c i joins point @c i to point @c (i + 1) % GetNumPoints(). Ties are
+     * resolved towards the lower index.
+     *
+     * @param point The query point.
+     * @return The index of the closest edge, or -1 if the polygon has no
+     *         points or a coordinate of the point is NaN.
+     */
+    int NearestEdge(const Point& point) const;
+
+    /**
+     * @brief Computes the minimum distance between this polygon and another.
+     *
+     * Polygons that overlap, touch, or contain one another are at distance 0.
+     * When both polygons are convex the distance is found with the
+     * Gilbert-Johnson-Keerthi algorithm on their Minkowski difference, which
+     * needs no index: each iteration finds its support vertices by binary
+     * search, so a query costs O(log n + log m) once the convexity of both
+     * polygons is cached (the first query classifies them in linear time).
+     * Otherwise both edge hierarchies are descended together, followed by a
+     * containment check when the boundaries do not meet.
+     *
+     * @param other The other polygon.
+     * @return The minimum distance, or -1.0 if either polygon has no points.
+     */
+    double DistanceTo(const Polygon& other) const;
     /**
      * @brief Exports the polygon to an SVG file.
      *
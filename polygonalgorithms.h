@@ -0,0 +1,243 @@
+#ifndef POLYGONALGORITHMS_H
+#define POLYGONALGORITHMS_H
+
+#include <algorithm>
+#include <cmath>
+
+#include "polygon.h"
+
+/*
+ * Point-sequence algorithms shared by Polygon and PolygonView, written once
+ * over a coordinate accessor so both storage layouts give identical answers.
+ * An accessor provides:
+ *
+ *     int Size() const;       // number of points
+ *     double X(int i) const;  // x-coordinate of point i
+ *     double Y(int i) const;  // y-coordinate of point i
+ *
+ * Only polygon.cpp and polygoncollection.cpp include this header.
+ */
+
+/**
+ * @brief Classifies the shape of a point sequence.
+ *
+ * The turn test is the one documented on Polygon::IsConvex(): all turns go
+ * the same way (within 1e-9) and not all points are collinear. Repeated
+ * points give zero-length edges, which are skipped, so turns are measured
+ * between consecutive edges of nonzero length. Sequences that pass are then
+ * told apart by how often the edges' x-direction changes sign: a closed curve
+ * turning one way and winding k times changes it 2k times.
+ *
+ * @param coords The coordinate accessor.
+ * @return The shape; never Convexity::Unknown.
+ */
+template <typename Coords>
+Convexity ClassifyConvexity(const Coords& coords)
+{
+    const int n = coords.Size();
+    if (n < 3) return Convexity::NotConvex;
+
+    bool positive = false;
+    bool negative = false;
+    const double EPS = 1e-9;
+
+    int xFlips = 0;
+    int firstSign = 0;
+    int lastSign = 0;
+
+    // First and previous edges of nonzero length.
+    bool haveEdge = false;
+    double firstDx = 0.0, firstDy = 0.0;
+    double prevDx = 0.0, prevDy = 0.0;
+    auto turn = [&](double dx, double dy) {
+        double cross = prevDx * dy - prevDy * dx;
+        if (cross > EPS) positive = true;
+        if (cross < -EPS) negative = true;
+    };
+
+    for (int i = 0; i < n; ++i) {
+        int j = (i + 1) % n;
+        double dx = coords.X(j) - coords.X(i);
+        double dy = coords.Y(j) - coords.Y(i);
+        if (dx == 0.0 && dy == 0.0) {
+            continue;
+        }
+
+        if (haveEdge) {
+            turn(dx, dy);
+            if (positive && negative) {
+                return Convexity::NotConvex; // Found both left and right turns
+            }
+        } else {
+            haveEdge = true;
+            firstDx = dx;
+            firstDy = dy;
+        }
+        prevDx = dx;
+        prevDy = dy;
+
+        int sign = (dx > 0.0) - (dx < 0.0);
+        if (sign != 0) {
+            if (firstSign == 0) {
+                firstSign = sign;
+            } else if (sign != lastSign) {
+                ++xFlips;
+            }
+            lastSign = sign;
+        }
+    }
+    if (haveEdge) {
+        turn(firstDx, firstDy);
+    }
+    if (lastSign != firstSign) {
+        ++xFlips;
+    }
+
+    if (positive && negative) {
+        return Convexity::NotConvex; // the closing turn went the other way
+    }
+    if (!positive && !negative) {
+        return Convexity::NotConvex; // all points are collinear
+    }
+    if (xFlips != 2) {
+        return Convexity::Wound;
+    }
+    return positive ? Convexity::Counterclockwise : Convexity::Clockwise;
+}
+
+/**
+ * @brief Checks whether a point lies on the segment (ax, ay)-(bx, by).
+ *
+ * The point must be inside the segment's bounding box grown by 1e-9 and
+ * within 1e-9 of its line. A zero-length segment holds the points within
+ * 1e-9 of its single point.
+ */
+inline bool IsOnEdge(double ax, double ay, double bx, double by, double px, double py)
+{
+    const double EPS = 1e-9;
+    if (px >= std::min(ax, bx) - EPS && px <= std::max(ax, bx) + EPS &&
+        py >= std::min(ay, by) - EPS && py <= std::max(ay, by) + EPS) {
+        double length = std::sqrt((bx - ax) * (bx - ax) + (by - ay) * (by - ay));
+        if (length == 0.0) {
+            return (px - ax) * (px - ax) + (py - ay) * (py - ay) <= EPS * EPS;
+        }
+        // |cross| / length is the distance from the point to the line.
+        double cross = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+        return std::fabs(cross) <= EPS * length;
+    }
+    return false;
+}
+
+/**
+ * @brief Locates a point by testing every edge; see Polygon::LocatePointLinear().
+ */
+template <typename Coords>
+PointLocation LocatePointLinear(const Coords& coords, double px, double py)
+{
+    const int n = coords.Size();
+    if (n < 3) {
+        return PointLocation::Invalid;
+    }
+
+    bool inside = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        double ax = coords.X(j), ay = coords.Y(j);
+        double bx = coords.X(i), by = coords.Y(i);
+
+        if (IsOnEdge(ax, ay, bx, by, px, py)) {
+            return PointLocation::OnEdge;
+        }
+
+        // Crossing test against the ray going right from the point.
+        if ((ay > py) != (by > py)) {
+            double xCross = ax + (py - ay) * (bx - ax) / (by - ay);
+            if (px < xCross) {
+                inside = !inside;
+            }
+        }
+    }
+
+    return inside ? PointLocation::Inside : PointLocation::Outside;
+}
+
+/**
+ * @brief Locates a point in a convex sequence in O(log n); see Polygon::LocatePoint().
+ * @param coords The coordinate accessor of a Counterclockwise or Clockwise sequence.
+ * @param px The x-coordinate of the point.
+ * @param py The y-coordinate of the point.
+ * @param orientation +1 for counterclockwise points, -1 for clockwise ones.
+ */
+template <typename Coords>
+PointLocation LocatePointConvex(const Coords& coords, double px, double py, int orientation)
+{
+    const int n = coords.Size();
+    const double x0 = coords.X(0);
+    const double y0 = coords.Y(0);
+
+    // Which side of the diagonal from vertex 0 to vertex i the point is on,
+    // positive to the left when walking counterclockwise.
+    auto side = [&](int i) {
+        double dx = coords.X(i) - x0;
+        double dy = coords.Y(i) - y0;
+        return orientation * (dx * (py - y0) - dy * (px - x0));
+    };
+    auto nearLine = [&](int i) {
+        double dx = coords.X(i) - x0;
+        double dy = coords.Y(i) - y0;
+        // Vertex i is not a copy of vertex 0, so the length is positive.
+        return std::fabs(side(i)) <= 1e-9 * std::sqrt(dx * dx + dy * dy);
+    };
+    auto onEdge = [&](int i) {
+        int j = (i + 1) % n;
+        return IsOnEdge(coords.X(i), coords.Y(i), coords.X(j), coords.Y(j), px, py);
+    };
+    auto isPivot = [&](int i) {
+        return coords.X(i) == x0 && coords.Y(i) == y0;
+    };
+
+    // Copies of vertex 0 (a closed ring repeats it at the end) span no wedge.
+    int first = 1;
+    while (first < n && isPivot(first)) {
+        ++first;
+    }
+    int last = n - 1;
+    while (last > first && isPivot(last)) {
+        --last;
+    }
+
+    // Vertices collinear with vertex 0 along its edges give empty wedges, so
+    // points near those two lines cannot be placed by the search.
+    if (last <= first || nearLine(first) || nearLine(last)) {
+        return LocatePointLinear(coords, px, py);
+    }
+
+    // Outside the angle at vertex 0: only the edges around it can be close.
+    if (side(first) < 0.0 || side(last) > 0.0) {
+        bool close = onEdge(first) || onEdge(last - 1);
+        return close ? PointLocation::OnEdge : PointLocation::Outside;
+    }
+
+    // The last diagonal with the point on its left starts the point's wedge.
+    int low = first;
+    int high = last;
+    while (high - low > 1) {
+        int middle = low + (high - low) / 2;
+        if (side(middle) >= 0.0) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    // Edge low -> high closes the wedge; the edges before and after it may
+    // pass within the tolerance near its endpoints.
+    if (onEdge(low - 1) || onEdge(low) || onEdge(high)) {
+        return PointLocation::OnEdge;
+    }
+    double ax = coords.X(low), ay = coords.Y(low);
+    double bx = coords.X(high), by = coords.Y(high);
+    double cross = (bx - ax) * (py - ay) - (by - ay) * (px - ax);
+    return orientation * cross > 0.0 ? PointLocation::Inside : PointLocation::Outside;
+}
+
+#endif // POLYGONALGORITHMS_H
@@ -0,0 +1,335 @@
+#include "polygoncollection.h"
+#include "polygonparser.h"
+#include "polygonalgorithms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+PolygonView::PolygonView(const double* xs, const double* ys, int numPoints)
+    : _xs(xs), _ys(ys), _numPoints(numPoints)
+{
+}
+
+int PolygonView::GetNumPoints() const
+{
+    return _numPoints;
+}
+
+double PolygonView::GetX(int index) const
+{
+    return _xs[index];
+}
+
+double PolygonView::GetY(int index) const
+{
+    return _ys[index];
+}
+
+Point PolygonView::GetPoint(int index) const
+{
+    return Point(_xs[index], _ys[index]);
+}
+
+namespace {
+
+// Coordinate accessor for the shared algorithms in polygonalgorithms.h.
+class ViewCoords
+{
+private:
+    const double* _xs;
+    const double* _ys;
+    int _numPoints;
+
+public:
+    ViewCoords(const double* xs, const double* ys, int numPoints)
+        : _xs(xs), _ys(ys), _numPoints(numPoints)
+    {
+    }
+    int Size() const { return _numPoints; }
+    double X(int i) const { return _xs[i]; }
+    double Y(int i) const { return _ys[i]; }
+};
+
+} // namespace
+
+bool PolygonView::IsConvex() const
+{
+    return ClassifyConvexity(ViewCoords(_xs, _ys, _numPoints)) != Convexity::NotConvex;
+}
+
+double PolygonView::Perimeter() const
+{
+    if (_numPoints < 2) {
+        return 0.0;
+    }
+
+    // Same summation order as Polygon::Perimeter(), closing edge last.
+    double perimeter = 0.0;
+    for (int i = 0; i + 1 < _numPoints; ++i) {
+        double dx = _xs[i] - _xs[i + 1];
+        double dy = _ys[i] - _ys[i + 1];
+        perimeter += std::sqrt(dx * dx + dy * dy);
+    }
+    double dx = _xs[_numPoints - 1] - _xs[0];
+    double dy = _ys[_numPoints - 1] - _ys[0];
+    perimeter += std::sqrt(dx * dx + dy * dy);
+    return perimeter;
+}
+
+PointLocation PolygonView::LocatePoint(const Point& point) const
+{
+    return LocatePointLinear(ViewCoords(_xs, _ys, _numPoints), point.GetX(), point.GetY());
+}
+
+Polygon PolygonView::ToPolygon() const
+{
+    Polygon polygon(_numPoints);
+    for (int i = 0; i < _numPoints; ++i) {
+        polygon.AddPoint(Point(_xs[i], _ys[i]));
+    }
+    return polygon;
+}
+
+PolygonCollection::PolygonCollection()
+    : _xs(), _ys(), _offsets(1, 0), _removed(), _numRemoved(0)
+{
+}
+
+void PolygonCollection::Reserve(int polygons, long points)
+{
+    _offsets.reserve(static_cast<size_t>(polygons) + 1);
+    _removed.reserve(polygons);
+    _xs.reserve(points);
+    _ys.reserve(points);
+}
+
+int PolygonCollection::GetNumPolygons() const
+{
+    return static_cast<int>(_removed.size());
+}
+
+int PolygonCollection::GetNumRemoved() const
+{
+    return _numRemoved;
+}
+
+long PolygonCollection::GetNumPoints() const
+{
+    return static_cast<long>(_xs.size());
+}
+
+PolygonView PolygonCollection::GetPolygon(int index) const
+{
+    long begin = _offsets[index];
+    int count = static_cast<int>(_offsets[index + 1] - begin);
+    return PolygonView(_xs.data() + begin, _ys.data() + begin, count);
+}
+
+bool PolygonCollection::IsRemoved(int index) const
+{
+    return _removed[index] != 0;
+}
+
+int PolygonCollection::Append(const Polygon& polygon)
+{
+    int n = polygon.GetNumPoints();
+    for (int i = 0; i < n; ++i) {
+        const Point* p = polygon.GetPoint(i);
+        _xs.push_back(p->GetX());
+        _ys.push_back(p->GetY());
+    }
+    _offsets.push_back(static_cast<long>(_xs.size()));
+    _removed.push_back(0);
+    return GetNumPolygons() - 1;
+}
+
+int PolygonCollection::Append(const PolygonView& polygon)
+{
+    int n = polygon._numPoints;
+    long start = static_cast<long>(_xs.size());
+
+    // The view may point into our own pool, which resizing can move.
+    const double* xs = polygon._xs;
+    const double* ys = polygon._ys;
+    bool own = !_xs.empty() && xs >= _xs.data() && xs < _xs.data() + start;
+    long source = own ? static_cast<long>(xs - _xs.data()) : 0;
+
+    _xs.resize(start + n);
+    _ys.resize(start + n);
+    if (own) {
+        xs = _xs.data() + source;
+        ys = _ys.data() + source;
+    }
+    std::copy(xs, xs + n, _xs.begin() + start);
+    std::copy(ys, ys + n, _ys.begin() + start);
+
+    _offsets.push_back(start + n);
+    _removed.push_back(0);
+    return GetNumPolygons() - 1;
+}
+
+bool PolygonCollection::Remove(int index)
+{
+    if (index < 0 || index >= GetNumPolygons() || _removed[index] != 0) {
+        return false;
+    }
+    _removed[index] = 1;
+    ++_numRemoved;
+    return true;
+}
+
+void PolygonCollection::Compact()
+{
+    if (_numRemoved == 0) {
+        return;
+    }
+
+    // Slide the surviving polygons down in place; writes never pass reads.
+    int count = GetNumPolygons();
+    int kept = 0;
+    long write = 0;
+    for (int i = 0; i < count; ++i) {
+        long begin = _offsets[i];
+        long end = _offsets[i + 1];
+        if (_removed[i] != 0) {
+            continue;
+        }
+        if (write != begin) {
+            std::copy(_xs.begin() + begin, _xs.begin() + end, _xs.begin() + write);
+            std::copy(_ys.begin() + begin, _ys.begin() + end, _ys.begin() + write);
+        }
+        _offsets[kept] = write;
+        write += end - begin;
+        ++kept;
+    }
+    _offsets[kept] = write;
+
+    _offsets.resize(kept + 1);
+    _removed.assign(kept, 0);
+    _xs.resize(write);
+    _ys.resize(write);
+    _numRemoved = 0;
+}
+
+void PolygonCollection::Transform(const AffineTransform& transform, BoundingBox* boxes,
+                                  int threads)
+{
+    int count = GetNumPolygons();
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::clamp(threads, 1, std::max(count, 1));
+
+    auto work = [&](int begin, int end) {
+        if (boxes == nullptr) {
+            long first = _offsets[begin];
+            transform.Apply(_xs.data() + first, _ys.data() + first, _offsets[end] - first);
+            return;
+        }
+        for (int i = begin; i < end; ++i) {
+            long first = _offsets[i];
+            transform.Apply(_xs.data() + first, _ys.data() + first,
+                            _offsets[i + 1] - first, &boxes[i]);
+        }
+    };
+    if (threads == 1) {
+        work(0, count);
+        return;
+    }
+
+    // Range t ends at the first polygon starting past t/threads of the points.
+    long total = GetNumPoints();
+    std::vector<std::thread> pool;
+    int begin = 0;
+    for (int t = 1; t <= threads; ++t) {
+        int end = count;
+        if (t < threads) {
+            long target = total * t / threads;
+            end = static_cast<int>(std::lower_bound(_offsets.begin(), _offsets.end() - 1, target) -
+                                   _offsets.begin());
+        }
+        if (end > begin) {
+            pool.emplace_back(work, begin, end);
+            begin = end;
+        }
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+void PolygonCollection::Clear()
+{
+    _xs.clear();
+    _ys.clear();
+    _offsets.assign(1, 0);
+    _removed.clear();
+    _numRemoved = 0;
+}
+
+namespace {
+
+// Appends parsed coordinates straight to the pool, with no Polygon in between.
+class PoolSink : public PolygonSink
+{
+private:
+    std::vector<double>& _xs;
+    std::vector<double>& _ys;
+    std::vector<long>& _offsets;
+    std::vector<unsigned char>& _removed;
+
+public:
+    long loaded = 0;
+
+    PoolSink(std::vector<double>& xs, std::vector<double>& ys, std::vector<long>& offsets,
+             std::vector<unsigned char>& removed)
+        : _xs(xs), _ys(ys), _offsets(offsets), _removed(removed)
+    {
+    }
+
+    void BeginPolygon(long, int) override
+    {
+    }
+
+    void AddPoint(double x, double y) override
+    {
+        _xs.push_back(x);
+        _ys.push_back(y);
+    }
+
+    void EndPolygon(const std::string&, int, double) override
+    {
+        _offsets.push_back(static_cast<long>(_xs.size()));
+        _removed.push_back(0);
+        ++loaded;
+    }
+};
+
+} // namespace
+
+long PolygonCollection::LoadFromStream(std::istream& in, std::string& error)
+{
+    const size_t CHUNK_SIZE = 1 << 20;
+
+    PolygonParser parser;
+    PoolSink sink(_xs, _ys, _offsets, _removed);
+    std::string chunk;
+    bool ok = true;
+
+    while (ok && PolygonParser::ReadChunk(in, chunk, CHUNK_SIZE)) {
+        ok = parser.Feed(chunk.data(), chunk.size(), sink);
+    }
+    if (ok) {
+        ok = parser.Finish();
+    }
+
+    if (!ok) {
+        // Drop the points of the polygon that was cut short.
+        _xs.resize(_offsets.back());
+        _ys.resize(_offsets.back());
+        error = parser.GetError();
+        return -1;
+    }
+    return sink.loaded;
+}
@@ -0,0 +1,230 @@
+#ifndef POLYGONCOLLECTION_H
+#define POLYGONCOLLECTION_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "affine.h"
+#include "point.h"
+#include "polygon.h"
+
+/**
+ * @class PolygonView
+ * @brief Read-only view of one polygon stored in a PolygonCollection.
+ *
+ * A view is two pointers and a count; it is cheap to copy and never allocates.
+ * Its geometric queries follow the same rules as the matching Polygon methods.
+ * A view is invalidated by any change to the collection it came from.
+ */
+class PolygonView
+{
+private:
+    const double* _xs; ///< x-coordinates of the points.
+    const double* _ys; ///< y-coordinates of the points.
+    int _numPoints;    ///< Number of points.
+
+    friend class PolygonCollection;
+
+public:
+    /**
+     * @brief Constructs a view over coordinate arrays.
+     * @param xs The x-coordinates of the points.
+     * @param ys The y-coordinates of the points.
+     * @param numPoints The number of points.
+     */
+    PolygonView(const double* xs, const double* ys, int numPoints);
+
+    /**
+     * @brief Gets the number of points in the polygon.
+     * @return The number of points.
+     */
+    int GetNumPoints() const;
+
+    /**
+     * @brief Gets the x-coordinate of a point.
+     * @param index The index of the point in the range [0, GetNumPoints()).
+     * @return The x-coordinate.
+     */
+    double GetX(int index) const;
+
+    /**
+     * @brief Gets the y-coordinate of a point.
+     * @param index The index of the point in the range [0, GetNumPoints()).
+     * @return The y-coordinate.
+     */
+    double GetY(int index) const;
+
+    /**
+     * @brief Returns a copy of a point.
+     * @param index The index of the point in the range [0, GetNumPoints()).
+     * @return The point.
+     */
+    Point GetPoint(int index) const;
+
+    /**
+     * @brief Checks whether the polygon is convex. See Polygon::IsConvex().
+     *
+     * Shares its implementation with Polygon, but is recomputed on every call.
+     *
+     * @return true if the polygon is convex, false otherwise.
+     */
+    bool IsConvex() const;
+
+    /**
+     * @brief Computes the perimeter of the polygon. See Polygon::Perimeter().
+     * @return The perimeter length. Returns 0.0 if there are fewer than 2 points.
+     */
+    double Perimeter() const;
+
+    /**
+     * @brief Determines the location of a point. See Polygon::LocatePointLinear().
+     *
+     * A view caches nothing, and classifying its convexity would already cost
+     * a full pass, so it always uses the crossing test; the answers are those
+     * of Polygon::LocatePointLinear() on the same points.
+     *
+     * @param point The point to test.
+     * @return The location of @p point relative to the polygon.
+     */
+    PointLocation LocatePoint(const Point& point) const;
+
+    /**
+     * @brief Copies the viewed polygon into a standalone Polygon.
+     * @return A polygon with the same points and a capacity equal to their number.
+     */
+    Polygon ToPolygon() const;
+};
+
+/**
+ * @class PolygonCollection
+ * @brief Stores many polygons in one flat pool of vertices.
+ *
+ * The coordinates of all polygons live in two contiguous arrays (one for x,
+ * one for y); polygon @c i owns the points in [offset[i], offset[i + 1]).
+ * Ten million polygons are therefore three allocations instead of tens of
+ * millions, and iterating over them walks memory sequentially.
+ *
+ * Removing a polygon only marks it; its slot and points stay in place, so
+ * indices remain stable, until Compact() squeezes them out.
+ */
+class PolygonCollection
+{
+private:
+    std::vector<double> _xs;             ///< x-coordinates of all points.
+    std::vector<double> _ys;             ///< y-coordinates of all points.
+    std::vector<long> _offsets;          ///< Start of each polygon, plus one past the last.
+    std::vector<unsigned char> _removed; ///< 1 for removed polygons.
+    int _numRemoved;                     ///< Number of removed polygons.
+
+public:
+    /**
+     * @brief Constructs an empty collection.
+     */
+    PolygonCollection();
+
+    /**
+     * @brief Reserves room for polygons and points to avoid regrowing the pool.
+     * @param polygons The expected number of polygons.
+     * @param points The expected total number of points.
+     */
+    void Reserve(int polygons, long points);
+
+    /**
+     * @brief Gets the number of polygon slots, including removed ones.
+     * @return The number of polygons.
+     */
+    int GetNumPolygons() const;
+
+    /**
+     * @brief Gets the number of removed polygons still waiting for Compact().
+     * @return The number of removed polygons.
+     */
+    int GetNumRemoved() const;
+
+    /**
+     * @brief Gets the total number of points in the pool.
+     * @return The number of points, including those of removed polygons.
+     */
+    long GetNumPoints() const;
+
+    /**
+     * @brief Returns a view of a polygon.
+     * @param index The index of the polygon in the range [0, GetNumPolygons()).
+     * @return A view of the polygon.
+     */
+    PolygonView GetPolygon(int index) const;
+
+    /**
+     * @brief Checks whether a polygon has been removed.
+     * @param index The index of the polygon in the range [0, GetNumPolygons()).
+     * @return true if the polygon was removed, false otherwise.
+     */
+    bool IsRemoved(int index) const;
+
+    /**
+     * @brief Appends a copy of a polygon.
+     * @param polygon The polygon to append.
+     * @return The index of the new polygon.
+     */
+    int Append(const Polygon& polygon);
+
+    /**
+     * @brief Appends a copy of a viewed polygon.
+     * @param polygon The view to append; it may point into this collection.
+     * @return The index of the new polygon.
+     */
+    int Append(const PolygonView& polygon);
+
+    /**
+     * @brief Marks a polygon as removed.
+     * @param index The index of the polygon in the range [0, GetNumPolygons()).
+     * @return true if the polygon was removed, false if the index is invalid
+     *         or the polygon was already removed.
+     */
+    bool Remove(int index);
+
+    /**
+     * @brief Drops removed polygons and their points from the pool.
+     *
+     * The remaining polygons keep their relative order but are renumbered.
+     */
+    void Compact();
+
+    /**
+     * @brief Applies an affine transform to every point of the pool, in place.
+     *
+     * The pool is cut into one range of polygons per thread, each holding
+     * about the same number of points, and every range is transformed by one
+     * tight loop over the coordinate arrays. Removed polygons are transformed
+     * too.
+     *
+     * @param transform The transform to apply.
+     * @param boxes Receives one bounding box per polygon, computed in the same
+     *        pass (may be nullptr).
+     * @param threads The number of threads to use (0 for all hardware threads).
+     */
+    void Transform(const AffineTransform& transform, BoundingBox* boxes = nullptr,
+                   int threads = 1);
+
+    /**
+     * @brief Removes every polygon, keeping the allocated memory.
+     */
+    void Clear();
+
+    /**
+     * @brief Appends every polygon of a text stream in the data/polygons.txt format.
+     *
+     * The expected values that follow each polygon are read and discarded.
+     * Coordinates go from the parser straight into the pool, so loading makes
+     * no per-polygon or per-point allocations.
+     *
+     * @param in The stream to read.
+     * @param error Receives a description of the problem if the input is malformed.
+     * @return The number of polygons appended, or -1 if the input is malformed.
+     *         Polygons read before the error stay in the collection.
+     */
+    long LoadFromStream(std::istream& in, std::string& error);
+};
+
+#endif // POLYGONCOLLECTION_H
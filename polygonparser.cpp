@@ -0,0 +1,213 @@
+#include "polygonparser.h"
+
+#include <cctype>
+#include <charconv>
+
+namespace {
+
+bool IsSpace(char c)
+{
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+bool ParseDouble(const char* begin, const char* end, double& value)
+{
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool ParseInt(const char* begin, const char* end, int& value)
+{
+    auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+} // namespace
+
+PolygonRecord::PolygonRecord(long index, int capacity)
+    : index(index), polygon(new Polygon(capacity)), convexFlag(),
+      expectedNumPoints(0), expectedPerimeter(0.0), convex(false), perimeter(0.0)
+{
+}
+
+PolygonRecord::~PolygonRecord()
+{
+    delete polygon;
+}
+
+PolygonParser::RecordBuilder::~RecordBuilder()
+{
+    delete current;
+}
+
+void PolygonParser::RecordBuilder::BeginPolygon(long index, int numPoints)
+{
+    delete current;
+    current = new PolygonRecord(index, numPoints);
+}
+
+void PolygonParser::RecordBuilder::AddPoint(double x, double y)
+{
+    current->polygon->AddPoint(Point(x, y));
+}
+
+void PolygonParser::RecordBuilder::EndPolygon(const std::string& convexFlag,
+                                              int expectedNumPoints, double expectedPerimeter)
+{
+    current->convexFlag = convexFlag;
+    current->expectedNumPoints = expectedNumPoints;
+    current->expectedPerimeter = expectedPerimeter;
+    out->push_back(current);
+    current = nullptr;
+}
+
+PolygonParser::PolygonParser()
+    : _state(State::Count), _remaining(0), _x(0.0), _flag(), _expectedNumPoints(0),
+      _nextIndex(0), _error(), _records()
+{
+}
+
+bool PolygonParser::Fail(const std::string& message)
+{
+    if (_error.empty()) {
+        _error = message + " in polygon " + std::to_string(_nextIndex + 1);
+    }
+    return false;
+}
+
+bool PolygonParser::Feed(const char* data, size_t size, std::vector<PolygonRecord*>& out)
+{
+    _records.out = &out;
+    return Feed(data, size, _records);
+}
+
+bool PolygonParser::Feed(const char* data, size_t size, PolygonSink& sink)
+{
+    if (!_error.empty()) {
+        return false;
+    }
+
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        if (IsSpace(*p)) {
+            ++p;
+            continue;
+        }
+        // A comma is a token of its own, so "x,y" and "x , y" both parse.
+        const char* start = p;
+        if (*p == ',') {
+            ++p;
+        } else {
+            while (p < end && !IsSpace(*p) && *p != ',') {
+                ++p;
+            }
+        }
+        if (!Token(start, p, sink)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PolygonParser::Token(const char* begin, const char* end, PolygonSink& sink)
+{
+    switch (_state) {
+    case State::Count: {
+        int n;
+        if (!ParseInt(begin, end, n) || n < 0) {
+            return Fail("Bad point count");
+        }
+        sink.BeginPolygon(_nextIndex, n);
+        _remaining = n;
+        _state = (n > 0) ? State::X : State::Flag;
+        return true;
+    }
+    case State::X:
+        if (!ParseDouble(begin, end, _x)) {
+            return Fail("Bad point format");
+        }
+        _state = State::Comma;
+        return true;
+    case State::Comma:
+        if (end - begin != 1 || *begin != ',') {
+            return Fail("Bad point format");
+        }
+        _state = State::Y;
+        return true;
+    case State::Y: {
+        double y;
+        if (!ParseDouble(begin, end, y)) {
+            return Fail("Bad point format");
+        }
+        sink.AddPoint(_x, y);
+        --_remaining;
+        _state = (_remaining > 0) ? State::X : State::Flag;
+        return true;
+    }
+    case State::Flag:
+        _flag.assign(begin, end);
+        _state = State::NumPoints;
+        return true;
+    case State::NumPoints:
+        if (!ParseInt(begin, end, _expectedNumPoints)) {
+            return Fail("Missing expectedNumPoints");
+        }
+        _state = State::Perimeter;
+        return true;
+    case State::Perimeter: {
+        double expectedPerimeter;
+        if (!ParseDouble(begin, end, expectedPerimeter)) {
+            return Fail("Missing expectedPerimeter");
+        }
+        sink.EndPolygon(_flag, _expectedNumPoints, expectedPerimeter);
+        ++_nextIndex;
+        _state = State::Count;
+        return true;
+    }
+    }
+    return false;
+}
+
+bool PolygonParser::Finish()
+{
+    if (!_error.empty()) {
+        return false;
+    }
+    switch (_state) {
+    case State::Count:
+        return true;
+    case State::X:
+    case State::Comma:
+    case State::Y:
+        return Fail("Bad point format");
+    case State::Flag:
+        return Fail("Missing convex flag");
+    case State::NumPoints:
+        return Fail("Missing expectedNumPoints");
+    case State::Perimeter:
+        return Fail("Missing expectedPerimeter");
+    }
+    return false;
+}
+
+const std::string& PolygonParser::GetError() const
+{
+    return _error;
+}
+
+bool PolygonParser::ReadChunk(std::istream& in, std::string& chunk, size_t blockSize)
+{
+    chunk.resize(blockSize);
+    in.read(&chunk[0], static_cast<std::streamsize>(blockSize));
+    chunk.resize(static_cast<size_t>(in.gcount()));
+    if (chunk.empty()) {
+        return false;
+    }
+    // Finish the token that straddles the end of the block.
+    char c;
+    while (!IsSpace(chunk.back()) && in.get(c)) {
+        chunk.push_back(c);
+    }
+    return true;
+}
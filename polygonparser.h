@@ -0,0 +1,191 @@
+#ifndef POLYGONPARSER_H
+#define POLYGONPARSER_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "polygon.h"
+
+/**
+ * @struct PolygonRecord
+ * @brief One polygon of a data file together with its expected and computed values.
+ *
+ * A record owns its polygon and deletes it on destruction.
+ */
+struct PolygonRecord
+{
+    long index;               ///< Position of the record in the input, starting at 0.
+    Polygon* polygon;         ///< The polygon read from the input (owned).
+    std::string convexFlag;   ///< Expected convexity as written in the file ("Yes"/"No").
+    int expectedNumPoints;    ///< Expected number of points.
+    double expectedPerimeter; ///< Expected perimeter (0 for non-convex polygons).
+    bool convex;              ///< Convexity computed by the metric stage.
+    double perimeter;         ///< Perimeter computed by the metric stage.
+
+    /**
+     * @brief Constructs a record holding an empty polygon of the given capacity.
+     * @param index The position of the record in the input.
+     * @param capacity The number of points of the polygon.
+     */
+    PolygonRecord(long index, int capacity);
+
+    /**
+     * @brief Destructor that frees the polygon.
+     */
+    ~PolygonRecord();
+
+    PolygonRecord(const PolygonRecord&) = delete;
+    PolygonRecord& operator=(const PolygonRecord&) = delete;
+};
+
+/**
+ * @class PolygonSink
+ * @brief Receives the polygons decoded by a PolygonParser, one coordinate at a time.
+ *
+ * A sink lets a container store the coordinates in its own layout without
+ * building an intermediate Polygon for every record.
+ */
+class PolygonSink
+{
+public:
+    virtual ~PolygonSink() = default;
+
+    /**
+     * @brief Starts a polygon.
+     * @param index The position of the record in the input, starting at 0.
+     * @param numPoints The number of points that follow.
+     */
+    virtual void BeginPolygon(long index, int numPoints) = 0;
+
+    /**
+     * @brief Adds the next point of the current polygon.
+     * @param x The x-coordinate.
+     * @param y The y-coordinate.
+     */
+    virtual void AddPoint(double x, double y) = 0;
+
+    /**
+     * @brief Completes the current polygon.
+     * @param convexFlag Expected convexity as written in the file.
+     * @param expectedNumPoints Expected number of points.
+     * @param expectedPerimeter Expected perimeter.
+     */
+    virtual void EndPolygon(const std::string& convexFlag, int expectedNumPoints,
+                            double expectedPerimeter) = 0;
+};
+
+/**
+ * @class PolygonParser
+ * @brief Incremental parser for the polygon text format of data/polygons.txt.
+ *
+ * Each record is a point count @c n, @c n points written as "x,y", the
+ * expected convexity flag, the expected number of points and the expected
+ * perimeter, all separated by whitespace. Input is fed in chunks that end on
+ * a token boundary (see ReadChunk()); a record may span several chunks.
+ */
+class PolygonParser
+{
+private:
+    /// The token the parser expects next.
+    enum class State {
+        Count,
+        X,
+        Comma,
+        Y,
+        Flag,
+        NumPoints,
+        Perimeter
+    };
+
+    /// Sink that turns polygons into PolygonRecords for the record overload of Feed().
+    class RecordBuilder : public PolygonSink
+    {
+    public:
+        PolygonRecord* current = nullptr;             ///< Record being filled (owned).
+        std::vector<PolygonRecord*>* out = nullptr;   ///< Receives completed records.
+
+        ~RecordBuilder() override;
+        void BeginPolygon(long index, int numPoints) override;
+        void AddPoint(double x, double y) override;
+        void EndPolygon(const std::string& convexFlag, int expectedNumPoints,
+                        double expectedPerimeter) override;
+    };
+
+    State _state;             ///< What the next token should be.
+    int _remaining;           ///< Points still to read for the current record.
+    double _x;                ///< x-coordinate of the point being read.
+    std::string _flag;        ///< Convexity flag of the current record.
+    int _expectedNumPoints;   ///< Expected number of points of the current record.
+    long _nextIndex;          ///< Index of the next record.
+    std::string _error;       ///< Description of the first error, empty if none.
+    RecordBuilder _records;   ///< Sink used by the record overload of Feed().
+
+    bool Token(const char* begin, const char* end, PolygonSink& sink);
+    bool Fail(const std::string& message);
+
+public:
+    /**
+     * @brief Constructs a parser positioned at the start of the input.
+     */
+    PolygonParser();
+
+
+    PolygonParser(const PolygonParser&) = delete;
+    PolygonParser& operator=(const PolygonParser&) = delete;
+
+    /**
+     * @brief Parses a chunk of input.
+     *
+     * Completed records are appended to @p out in input order; the caller
+     * takes ownership of them. After an error the parser ignores further input.
+     *
+     * @param data The chunk of text; it must end on a token boundary.
+     * @param size The number of characters in the chunk.
+     * @param out Receives the records completed by this chunk.
+     * @return true on success, false if the input is malformed.
+     */
+    bool Feed(const char* data, size_t size, std::vector<PolygonRecord*>& out);
+
+    /**
+     * @brief Parses a chunk of input into a sink.
+     *
+     * The sink sees every polygon as BeginPolygon(), one AddPoint() per point
+     * and EndPolygon(); after an error the current polygon is never ended.
+     * A parser must be fed through one overload only.
+     *
+     * @param data The chunk of text; it must end on a token boundary.
+     * @param size The number of characters in the chunk.
+     * @param sink Receives the decoded polygons.
+     * @return true on success, false if the input is malformed.
+     */
+    bool Feed(const char* data, size_t size, PolygonSink& sink);
+
+    /**
+     * @brief Signals the end of the input.
+     * @return true if the input ended between records, false otherwise.
+     */
+    bool Finish();
+
+    /**
+     * @brief Gets the description of the first error.
+     * @return The error message, or an empty string if there was no error.
+     */
+    const std::string& GetError() const;
+
+    /**
+     * @brief Reads the next chunk of a stream, ending on a token boundary.
+     *
+     * About @p blockSize characters are read, followed by the rest of the
+     * token that straddles the block's end, if any.
+     *
+     * @param in The stream to read from.
+     * @param chunk Receives the characters read.
+     * @param blockSize The number of characters to read before looking for a boundary.
+     * @return true if anything was read, false at the end of the stream.
+     */
+    static bool ReadChunk(std::istream& in, std::string& chunk, size_t blockSize);
+};
+
+#endif // POLYGONPARSER_H
@@ -0,0 +1,289 @@
+#include "raster.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int TILE_ROWS = 32;
+
+/// A non-horizontal polygon edge, oriented from its lower to its upper end.
+struct Edge {
+    double yMin;  ///< y of the lower endpoint (inclusive).
+    double yMax;  ///< y of the upper endpoint (exclusive).
+    double xAtMin; ///< x of the lower endpoint.
+    double slope;  ///< dx/dy along the edge.
+};
+
+/// The edges of one polygon, sorted by yMin, and bucketed by the tiles of
+/// rows they overlap so each tile starts from its own edges.
+struct EdgeTable {
+    std::vector<Edge> edges;
+    double minY;
+    double maxY;
+    int firstTile;                ///< First tile overlapped by the polygon.
+    int lastTile;                 ///< Last tile overlapped by the polygon (< firstTile if none).
+    std::vector<int> tileOffsets; ///< Start of each tile's run in tileEdges, plus the end.
+    std::vector<int> tileEdges;   ///< Edge indices per tile, each run sorted by yMin.
+};
+
+EdgeTable BuildEdgeTable(const Polygon& polygon, double originY, double tileHeight,
+                         int numTiles)
+{
+    EdgeTable table;
+    int n = polygon.GetNumPoints();
+    table.edges.reserve(n);
+    table.minY = 0.0;
+    table.maxY = 0.0;
+    table.firstTile = 0;
+    table.lastTile = -1;
+    for (int i = 0; i < n; ++i) {
+        const Point* a = polygon.GetPoint(i);
+        const Point* b = polygon.GetPoint((i + 1) % n);
+        double ax = a->GetX(), ay = a->GetY();
+        double bx = b->GetX(), by = b->GetY();
+        if (ay == by) {
+            continue; // horizontal edges never cross a scanline
+        }
+        if (ay > by) {
+            std::swap(ax, bx);
+            std::swap(ay, by);
+        }
+        table.edges.push_back(Edge{ay, by, ax, (bx - ax) / (by - ay)});
+    }
+    std::sort(table.edges.begin(), table.edges.end(),
+              [](const Edge& e1, const Edge& e2) { return e1.yMin < e2.yMin; });
+    if (table.edges.empty()) {
+        return table;
+    }
+    table.minY = table.edges.front().yMin;
+    table.maxY = table.minY;
+    for (const Edge& e : table.edges) {
+        table.maxY = std::max(table.maxY, e.yMax);
+    }
+
+    // Tiles an edge overlaps, clamped to the grid. Scanlines sit at least
+    // half a sample away from tile boundaries, so rounding here is harmless.
+    auto tileRange = [&](double yMin, double yMax, int& first, int& last) {
+        double lower = std::floor((yMin - originY) / tileHeight);
+        double upper = std::ceil((yMax - originY) / tileHeight) - 1.0;
+        first = static_cast<int>(std::clamp(lower, 0.0, static_cast<double>(numTiles)));
+        last = static_cast<int>(std::clamp(upper, -1.0, numTiles - 1.0));
+    };
+    tileRange(table.minY, table.maxY, table.firstTile, table.lastTile);
+    if (table.lastTile < table.firstTile) {
+        return table;
+    }
+
+    // Counting sort into the buckets; walking the edges in yMin order keeps
+    // every bucket sorted.
+    int tiles = table.lastTile - table.firstTile + 1;
+    table.tileOffsets.assign(tiles + 1, 0);
+    for (const Edge& e : table.edges) {
+        int first, last;
+        tileRange(e.yMin, e.yMax, first, last);
+        for (int t = first; t <= last; ++t) {
+            ++table.tileOffsets[t - table.firstTile + 1];
+        }
+    }
+    for (int t = 0; t < tiles; ++t) {
+        table.tileOffsets[t + 1] += table.tileOffsets[t];
+    }
+    table.tileEdges.resize(table.tileOffsets[tiles]);
+    std::vector<int> fill(table.tileOffsets.begin(), table.tileOffsets.end() - 1);
+    for (int i = 0; i < static_cast<int>(table.edges.size()); ++i) {
+        int first, last;
+        tileRange(table.edges[i].yMin, table.edges[i].yMax, first, last);
+        for (int t = first; t <= last; ++t) {
+            table.tileEdges[fill[t - table.firstTile]++] = i;
+        }
+    }
+    return table;
+}
+
+/// Walks the scanlines of one polygon inside a tile, maintaining its
+/// active-edge table and handing each span to the caller.
+class ScanWalker
+{
+private:
+    const EdgeTable& _table;
+    std::vector<const Edge*> _active;
+    std::vector<double> _crossings;
+    const int* _next;
+    const int* _end;
+
+public:
+    ScanWalker(const EdgeTable& table, int tile)
+        : _table(table),
+          _next(table.tileEdges.data() + table.tileOffsets[tile - table.firstTile]),
+          _end(table.tileEdges.data() + table.tileOffsets[tile - table.firstTile + 1])
+    {
+    }
+
+    /// Calls span(x0, x1) for each inside interval of the scanline at y.
+    /// Scanlines must be visited in increasing y within the tile.
+    template <typename SpanFn>
+    void Scan(double y, SpanFn span)
+    {
+        while (_next != _end && _table.edges[*_next].yMin <= y) {
+            _active.push_back(&_table.edges[*_next]);
+            ++_next;
+        }
+        _active.erase(std::remove_if(_active.begin(), _active.end(),
+                                     [y](const Edge* e) { return e->yMax <= y; }),
+                      _active.end());
+
+        _crossings.clear();
+        for (const Edge* e : _active) {
+            _crossings.push_back(e->xAtMin + (y - e->yMin) * e->slope);
+        }
+        std::sort(_crossings.begin(), _crossings.end());
+        for (size_t k = 0; k + 1 < _crossings.size(); k += 2) {
+            span(_crossings[k], _crossings[k + 1]);
+        }
+    }
+};
+
+} // namespace
+
+Rasterizer::Rasterizer(int width, int height, double originX, double originY,
+                       double cellSize)
+    : _width(width), _height(height), _originX(originX), _originY(originY),
+      _cellSize(cellSize)
+{
+}
+
+int Rasterizer::GetWidth() const
+{
+    return _width;
+}
+
+int Rasterizer::GetHeight() const
+{
+    return _height;
+}
+
+void Rasterizer::FillMask(const Polygon& polygon, unsigned char* mask, int threads) const
+{
+    Fill(&polygon, 1, mask, nullptr, 1, threads);
+}
+
+void Rasterizer::FillMask(const Polygon* polygons, int count, unsigned char* mask,
+                          int threads) const
+{
+    Fill(polygons, count, mask, nullptr, 1, threads);
+}
+
+void Rasterizer::FillCoverage(const Polygon& polygon, float* coverage, int samples,
+                              int threads) const
+{
+    Fill(&polygon, 1, nullptr, coverage, samples, threads);
+}
+
+void Rasterizer::FillCoverage(const Polygon* polygons, int count, float* coverage,
+                              int samples, int threads) const
+{
+    Fill(polygons, count, nullptr, coverage, samples, threads);
+}
+
+void Rasterizer::Fill(const Polygon* polygons, int count, unsigned char* mask,
+                      float* coverage, int samples, int threads) const
+{
+    if (_width <= 0 || _height <= 0 || count <= 0) {
+        return;
+    }
+    samples = std::max(samples, 1);
+
+    // Edges are bucketed by tile once, up front, so a tile never looks at
+    // edges that lie entirely below or above it.
+    int numTiles = (_height + TILE_ROWS - 1) / TILE_ROWS;
+    std::vector<EdgeTable> tables;
+    tables.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (polygons[i].GetNumPoints() >= 3) {
+            tables.push_back(BuildEdgeTable(polygons[i], _originY, TILE_ROWS * _cellSize,
+                                            numTiles));
+        }
+    }
+
+    std::atomic<int> nextTile(0);
+
+    auto worker = [&]() {
+        for (int tile = nextTile++; tile < numTiles; tile = nextTile++) {
+            int rowBegin = tile * TILE_ROWS;
+            int rowEnd = std::min(rowBegin + TILE_ROWS, _height);
+            double tileBottom = _originY + rowBegin * _cellSize;
+            double tileTop = _originY + rowEnd * _cellSize;
+
+            for (const EdgeTable& table : tables) {
+                if (tile < table.firstTile || tile > table.lastTile ||
+                    table.maxY <= tileBottom || table.minY >= tileTop) {
+                    continue;
+                }
+                ScanWalker walker(table, tile);
+                for (int row = rowBegin; row < rowEnd; ++row) {
+                    if (mask != nullptr) {
+                        unsigned char* line = mask + static_cast<long>(row) * _width;
+                        double y = _originY + (row + 0.5) * _cellSize;
+                        walker.Scan(y, [&](double x0, double x1) {
+                            // Cells whose center lies in [x0, x1).
+                            double u0 = (x0 - _originX) / _cellSize - 0.5;
+                            double u1 = (x1 - _originX) / _cellSize - 0.5;
+                            const double w = static_cast<double>(_width);
+                            int c0 = static_cast<int>(std::clamp(std::ceil(u0), 0.0, w));
+                            int c1 = static_cast<int>(std::clamp(std::ceil(u1), 0.0, w));
+                            for (int c = c0; c < c1; ++c) {
+                                line[c] = 1;
+                            }
+                        });
+                        continue;
+                    }
+
+                    float* line = coverage + static_cast<long>(row) * _width;
+                    const double weight = 1.0 / samples;
+                    for (int s = 0; s < samples; ++s) {
+                        double y = _originY + (row + (s + 0.5) / samples) * _cellSize;
+                        walker.Scan(y, [&](double x0, double x1) {
+                            // Exact overlap of [x0, x1) with each cell, in cell units.
+                            double u0 = std::max((x0 - _originX) / _cellSize, 0.0);
+                            double u1 = std::min((x1 - _originX) / _cellSize,
+                                                 static_cast<double>(_width));
+                            if (u1 <= u0) {
+                                return;
+                            }
+                            int c0 = static_cast<int>(std::floor(u0));
+                            int c1 = std::min(static_cast<int>(std::ceil(u1)), _width);
+                            for (int c = c0; c < c1; ++c) {
+                                double overlap = std::min(u1, c + 1.0) -
+                                                 std::max(u0, static_cast<double>(c));
+                                line[c] += static_cast<float>(overlap * weight);
+                            }
+                        });
+                    }
+                }
+            }
+        }
+    };
+
+    if (threads <= 0) {
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    threads = std::clamp(threads, 1, numTiles);
+    if (threads == 1) {
+        worker();
+        return;
+    }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
@@ -0,0 +1,121 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+/**
+ * @class SpscQueue
+ * @brief Bounded lock-free queue for exactly one producer and one consumer thread.
+ *
+ * The queue is a ring buffer indexed by two ever-increasing counters: the
+ * producer only writes @c _tail and the consumer only writes @c _head, so no
+ * lock or compare-and-swap is needed. The blocking Push() and Pop() spin for a
+ * short while and then back off with short sleeps, which keeps idle stages
+ * from stealing cores from busy ones.
+ *
+ * @tparam T The element type; it must be default constructible and copyable.
+ */
+template <typename T>
+class SpscQueue
+{
+private:
+    T* _slots;          ///< Ring buffer of @c _capacity elements.
+    size_t _capacity;   ///< Maximum number of queued elements.
+    alignas(64) std::atomic<size_t> _head; ///< Number of elements popped so far.
+    alignas(64) std::atomic<size_t> _tail; ///< Number of elements pushed so far.
+
+    static void Backoff(int& attempts)
+    {
+        ++attempts;
+        if (attempts < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an empty queue.
+     * @param capacity The maximum number of queued elements (at least 1).
+     */
+    explicit SpscQueue(size_t capacity)
+        : _slots(nullptr), _capacity(capacity > 0 ? capacity : 1), _head(0), _tail(0)
+    {
+        _slots = new T[_capacity];
+    }
+
+    /**
+     * @brief Destructor that frees the ring buffer (not what the elements point to).
+     */
+    ~SpscQueue()
+    {
+        delete[] _slots;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Appends an element if there is room. Producer thread only.
+     * @param value The element to append.
+     * @return true if the element was queued, false if the queue is full.
+     */
+    bool TryPush(const T& value)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) >= _capacity) {
+            return false;
+        }
+        _slots[tail % _capacity] = value;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest element if there is one. Consumer thread only.
+     * @param value Receives the removed element.
+     * @return true if an element was removed, false if the queue is empty.
+     */
+    bool TryPop(T& value)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = _slots[head % _capacity];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Appends an element, waiting while the queue is full.
+     * @param value The element to append.
+     */
+    void Push(const T& value)
+    {
+        int attempts = 0;
+        while (!TryPush(value)) {
+            Backoff(attempts);
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element, waiting while the queue is empty.
+     * @return The removed element.
+     */
+    T Pop()
+    {
+        T value;
+        int attempts = 0;
+        while (!TryPop(value)) {
+            Backoff(attempts);
+        }
+        return value;
+    }
+};
+
+#endif // SPSCQUEUE_H
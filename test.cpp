@@ -1,9 +1,19 @@
 #include <iostream>
 #include <cmath>
+#include <limits>
 #include <string>
 
 #include "point.h"
 #include "polygon.h"
+#include "raster.h"
+#include "pipeline.h"
+#include "polygoncollection.h"
+#include "affine.h"
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 struct TestStats {
     int passed = 0;
@@ -213,8 +223,833 @@ void TestPolygonLocatePoint(TestStats& stats) {
     // On edge between (4,2) and (2,4): midpoint (3,3)
     ASSERT_TRUE("LocatePoint pentagon on-edge #2 (diagonal edge midpoint)",
                 pentagon.LocatePoint(Point(3.0, 3.0)) == PointLocation::OnEdge, stats);
+
+    // Short edges: the tolerance is a distance, not scaled down with the edge
+    Polygon tiny(3);
+    tiny.AddPoint(Point(0.0, 0.0));
+    tiny.AddPoint(Point(1e-3, 0.0));
+    tiny.AddPoint(Point(0.0, 1e-3));
+    // 7e-7 beyond the hypotenuse x + y = 1e-3
+    Point beyond(5.005e-4, 5.005e-4);
+    ASSERT_TRUE("LocatePoint short edge outside",
+                tiny.LocatePoint(beyond) == PointLocation::Outside, stats);
+    ASSERT_TRUE("LocatePointLinear short edge outside",
+                tiny.LocatePointLinear(beyond) == PointLocation::Outside, stats);
+    Point onHypotenuse(5e-4, 5e-4);
+    ASSERT_TRUE("LocatePoint short edge on-edge",
+                tiny.LocatePoint(onHypotenuse) == PointLocation::OnEdge, stats);
+    ASSERT_TRUE("LocatePointLinear short edge on-edge",
+                tiny.LocatePointLinear(onHypotenuse) == PointLocation::OnEdge, stats);
+}
+
+// Brute-force distance from a point to the polygon's boundary.
+double BruteBoundaryDistance(const Polygon& poly, const Point& q) {
+    double best = -1.0;
+    int n = poly.GetNumPoints();
+    for (int i = 0; i < n; ++i) {
+        const Point& a = *poly.GetPoint(i);
+        const Point& b = *poly.GetPoint((i + 1) % n);
+        double dx = b.GetX() - a.GetX();
+        double dy = b.GetY() - a.GetY();
+        double lenSq = dx * dx + dy * dy;
+        double t = lenSq > 0.0
+            ? ((q.GetX() - a.GetX()) * dx + (q.GetY() - a.GetY()) * dy) / lenSq
+            : 0.0;
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+        double d = q.Distance(Point(a.GetX() + t * dx, a.GetY() + t * dy));
+        if (best < 0.0 || d < best) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+// Star-shaped (hence simple, usually concave) polygon around (cx, cy).
+Polygon MakeStar(int n, double cx, double cy, double inner, double outer) {
+    Polygon star(n);
+    for (int i = 0; i < n; ++i) {
+        double angle = 2.0 * M_PI * i / n;
+        double r = (i % 2 == 0) ? outer : inner;
+        star.AddPoint(Point(cx + r * std::cos(angle), cy + r * std::sin(angle)));
+    }
+    return star;
+}
+
+void TestPolygonDistance(TestStats& stats) {
+    std::cout << "Running TestPolygonDistance...\n";
+
+    Polygon square(4);
+    square.AddPoint(Point(0.0, 0.0));
+    square.AddPoint(Point(2.0, 0.0));
+    square.AddPoint(Point(2.0, 2.0));
+    square.AddPoint(Point(0.0, 2.0));
+
+    ASSERT_CLOSE("DistanceToBoundary outside right",
+                 square.DistanceToBoundary(Point(5.0, 1.0)), 3.0, stats);
+    ASSERT_CLOSE("DistanceToBoundary outside corner",
+                 square.DistanceToBoundary(Point(5.0, 6.0)), 5.0, stats);
+    ASSERT_CLOSE("DistanceToBoundary inside",
+                 square.DistanceToBoundary(Point(1.5, 1.0)), 0.5, stats);
+    ASSERT_CLOSE("DistanceToBoundary on edge",
+                 square.DistanceToBoundary(Point(1.0, 0.0)), 0.0, stats);
+    ASSERT_TRUE("NearestEdge bottom", square.NearestEdge(Point(1.0, -1.0)) == 0, stats);
+    ASSERT_TRUE("NearestEdge right", square.NearestEdge(Point(1.9, 1.0)) == 1, stats);
+    ASSERT_TRUE("NearestEdge left", square.NearestEdge(Point(-3.0, 1.0)) == 3, stats);
+
+    Polygon empty(3);
+    ASSERT_TRUE("DistanceToBoundary empty == -1",
+                empty.DistanceToBoundary(Point(0.0, 0.0)) == -1.0, stats);
+    ASSERT_TRUE("NearestEdge empty == -1",
+                empty.NearestEdge(Point(0.0, 0.0)) == -1, stats);
+
+    // Non-finite queries
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    ASSERT_TRUE("NearestEdge NaN == -1", square.NearestEdge(Point(nan, 1.0)) == -1, stats);
+    ASSERT_TRUE("DistanceToBoundary NaN is NaN",
+                std::isnan(square.DistanceToBoundary(Point(1.0, nan))), stats);
+    int farEdge = square.NearestEdge(Point(inf, inf));
+    ASSERT_TRUE("NearestEdge infinity is an edge", farEdge >= 0 && farEdge < 4, stats);
+    ASSERT_TRUE("DistanceToBoundary infinity",
+                square.DistanceToBoundary(Point(inf, 1.0)) == inf, stats);
+
+    // At a vertex both edges meeting there are at distance 0; the lower index wins.
+    const int SIDES = 64;
+    Polygon gon(SIDES);
+    for (int i = 0; i < SIDES; ++i) {
+        double angle = 2.0 * M_PI * i / SIDES;
+        gon.AddPoint(Point(10.0 * std::cos(angle), 10.0 * std::sin(angle)));
+    }
+    bool lowerIndex = true;
+    for (int k = 0; k < SIDES; ++k) {
+        int expected = (k == 0) ? 0 : k - 1;
+        lowerIndex = lowerIndex && gon.NearestEdge(*gon.GetPoint(k)) == expected;
+    }
+    ASSERT_TRUE("NearestEdge ties go to the lower index", lowerIndex, stats);
+
+    // Convex pairs (GJK path)
+    Polygon triangle(3);
+    triangle.AddPoint(Point(5.0, 0.0));
+    triangle.AddPoint(Point(8.0, 0.0));
+    triangle.AddPoint(Point(5.0, 3.0));
+    ASSERT_CLOSE("DistanceTo convex disjoint", square.DistanceTo(triangle), 3.0, stats);
+    ASSERT_CLOSE("DistanceTo convex symmetric", triangle.DistanceTo(square), 3.0, stats);
+
+    Polygon diamond(4);
+    diamond.AddPoint(Point(4.0, 4.0));
+    diamond.AddPoint(Point(5.0, 5.0));
+    diamond.AddPoint(Point(4.0, 6.0));
+    diamond.AddPoint(Point(3.0, 5.0));
+    ASSERT_CLOSE("DistanceTo convex vertex-vertex",
+                 square.DistanceTo(diamond), std::sqrt(8.0), stats);
+
+    Polygon overlap(4);
+    overlap.AddPoint(Point(1.0, 1.0));
+    overlap.AddPoint(Point(3.0, 1.0));
+    overlap.AddPoint(Point(3.0, 3.0));
+    overlap.AddPoint(Point(1.0, 3.0));
+    ASSERT_CLOSE("DistanceTo convex overlapping", square.DistanceTo(overlap), 0.0, stats);
+
+    Polygon inner(3);
+    inner.AddPoint(Point(0.5, 0.5));
+    inner.AddPoint(Point(1.5, 0.5));
+    inner.AddPoint(Point(1.0, 1.5));
+    ASSERT_CLOSE("DistanceTo convex contained", square.DistanceTo(inner), 0.0, stats);
+
+    // Large regular polygons in both orientations, plus a closed ring.
+    const int ROUND = 1000;
+    Polygon wheel(ROUND);
+    Polygon backwards(ROUND + 1);
+    for (int i = 0; i < ROUND; ++i) {
+        double angle = 2.0 * M_PI * i / ROUND;
+        wheel.AddPoint(Point(std::cos(angle), std::sin(angle)));
+        backwards.AddPoint(Point(5.0 + std::cos(-angle), 1.0 + std::sin(-angle)));
+    }
+    backwards.AddPoint(*backwards.GetPoint(0));
+    double centers = std::sqrt(26.0);
+    ASSERT_TRUE("DistanceTo convex opposite orientations",
+                AlmostEqual(wheel.DistanceTo(backwards), centers - 2.0, 1e-4), stats);
+    ASSERT_TRUE("DistanceTo convex opposite orientations symmetric",
+                AlmostEqual(backwards.DistanceTo(wheel), centers - 2.0, 1e-4), stats);
+
+    // Repeated vertices: the support search must not stop on equal neighbours.
+    Polygon ring(5);
+    ring.AddPoint(Point(0.0, 0.0));
+    ring.AddPoint(Point(4.0, 0.0));
+    ring.AddPoint(Point(4.0, 4.0));
+    ring.AddPoint(Point(0.0, 4.0));
+    ring.AddPoint(Point(0.0, 0.0));
+    Polygon above(3);
+    above.AddPoint(Point(3.57, 8.82));
+    above.AddPoint(Point(4.57, 8.82));
+    above.AddPoint(Point(3.57, 9.82));
+    ASSERT_CLOSE("DistanceTo convex closed ring", ring.DistanceTo(above), 4.82, stats);
+    Polygon left(4);
+    left.AddPoint(Point(-2.0, 2.0));
+    left.AddPoint(Point(-1.0, 2.0));
+    left.AddPoint(Point(-1.0, 2.0));
+    left.AddPoint(Point(-2.0, 3.0));
+    ASSERT_CLOSE("DistanceTo convex repeated vertex", ring.DistanceTo(left), 1.0, stats);
+
+    // General polygons (edge hierarchy path)
+    Polygon concave(5);
+    concave.AddPoint(Point(0.0, 0.0));
+    concave.AddPoint(Point(2.0, 0.0));
+    concave.AddPoint(Point(2.0, 2.0));
+    concave.AddPoint(Point(1.0, 1.0));
+    concave.AddPoint(Point(0.0, 2.0));
+    ASSERT_CLOSE("DistanceTo concave vs triangle",
+                 concave.DistanceTo(triangle), 3.0, stats);
+    Polygon pocket(3);
+    pocket.AddPoint(Point(0.9, 1.6));
+    pocket.AddPoint(Point(1.1, 1.6));
+    pocket.AddPoint(Point(1.0, 1.8));
+    ASSERT_CLOSE("DistanceTo concave notch",
+                 concave.DistanceTo(pocket), 0.5 / std::sqrt(2.0), stats);
+
+    Polygon bigStar = MakeStar(2000, 0.0, 0.0, 50.0, 100.0);
+    Polygon smallStar = MakeStar(40, 0.0, 0.0, 5.0, 10.0);
+    ASSERT_CLOSE("DistanceTo star contained", bigStar.DistanceTo(smallStar), 0.0, stats);
+    Polygon farStar = MakeStar(40, 300.0, 0.0, 5.0, 10.0);
+    ASSERT_CLOSE("DistanceTo star disjoint", bigStar.DistanceTo(farStar), 190.0, stats);
+
+    bool allMatch = true;
+    for (int k = 0; k < 200; ++k) {
+        Point q(-150.0 + 1.5 * k, 80.0 * std::sin(0.37 * k));
+        double fast = bigStar.DistanceToBoundary(q);
+        double slow = BruteBoundaryDistance(bigStar, q);
+        allMatch = allMatch && AlmostEqual(fast, slow, 1e-9);
+    }
+    ASSERT_TRUE("DistanceToBoundary matches brute force on 2000-gon", allMatch, stats);
+
+    // The cached hierarchy must follow modifications.
+    square.SetPoint(1, Point(4.0, 0.0));
+    ASSERT_CLOSE("DistanceToBoundary after SetPoint",
+                 square.DistanceToBoundary(Point(5.0, 0.0)), 1.0, stats);
+    Polygon copy(square);
+    ASSERT_CLOSE("DistanceToBoundary on copy",
+                 copy.DistanceToBoundary(Point(5.0, 0.0)), 1.0, stats);
 }
 
+void TestRasterizer(TestStats& stats) {
+    std::cout << "Running TestRasterizer...\n";
+
+    // Concave polygon on a 64x48 grid of 0.25 cells, compared cell by cell
+    // against LocatePoint at the cell centers.
+    Polygon concave(6);
+    concave.AddPoint(Point(0.3, 0.2));
+    concave.AddPoint(Point(14.1, 1.1));
+    concave.AddPoint(Point(9.7, 6.3));
+    concave.AddPoint(Point(7.2, 2.9));
+    concave.AddPoint(Point(4.4, 10.6));
+    concave.AddPoint(Point(1.3, 8.8));
+
+    Rasterizer raster(64, 48, 0.0, 0.0, 0.25);
+    std::vector<unsigned char> mask(64 * 48, 0);
+    raster.FillMask(concave, mask.data());
+
+    int mismatches = 0;
+    int filled = 0;
+    for (int row = 0; row < 48; ++row) {
+        for (int col = 0; col < 64; ++col) {
+            Point center((col + 0.5) * 0.25, (row + 0.5) * 0.25);
+            PointLocation loc = concave.LocatePoint(center);
+            if (loc == PointLocation::OnEdge) {
+                continue;
+            }
+            bool inside = (loc == PointLocation::Inside);
+            if (inside != (mask[row * 64 + col] == 1)) {
+                ++mismatches;
+            }
+            filled += inside ? 1 : 0;
+        }
+    }
+    ASSERT_TRUE("FillMask matches LocatePoint", mismatches == 0, stats);
+    ASSERT_TRUE("FillMask filled something", filled > 0, stats);
+
+    std::vector<unsigned char> threaded(64 * 48, 0);
+    raster.FillMask(concave, threaded.data(), 4);
+    ASSERT_TRUE("FillMask threaded == single-threaded", threaded == mask, stats);
+
+    // Square aligned to cell boundaries on x and half a cell on y.
+    Polygon square(4);
+    square.AddPoint(Point(1.0, 1.5));
+    square.AddPoint(Point(3.0, 1.5));
+    square.AddPoint(Point(3.0, 3.0));
+    square.AddPoint(Point(1.0, 3.0));
+    Rasterizer unit(5, 5, 0.0, 0.0, 1.0);
+    std::vector<float> coverage(25, 0.0f);
+    unit.FillCoverage(square, coverage.data(), 4);
+    ASSERT_CLOSE("FillCoverage full cell", coverage[2 * 5 + 1], 1.0, stats);
+    ASSERT_CLOSE("FillCoverage half cell", coverage[1 * 5 + 2], 0.5, stats);
+    ASSERT_CLOSE("FillCoverage outside cell", coverage[0 * 5 + 0], 0.0, stats);
+    double total = 0.0;
+    for (float c : coverage) {
+        total += c;
+    }
+    ASSERT_TRUE("FillCoverage total == area", AlmostEqual(total, 3.0, 1e-5), stats);
+
+    // Two polygons accumulate into the same buffer.
+    Polygon both[2] = {square, square};
+    std::vector<float> doubled(25, 0.0f);
+    unit.FillCoverage(both, 2, doubled.data(), 4, 0);
+    ASSERT_CLOSE("FillCoverage collection accumulates", doubled[2 * 5 + 1], 2.0, stats);
+
+    // A star taller than a canvas of many tiles: edges are bucketed per tile
+    // and some of them start below or end above the grid.
+    Polygon star = MakeStar(150, 0.0, 0.0, 6.0, 20.0);
+    const int W = 40, H = 300;
+    Rasterizer tall(W, H, -2.0, -15.0, 0.1);
+    std::vector<unsigned char> tallMask(W * H, 0);
+    tall.FillMask(star, tallMask.data(), 3);
+    int tallMismatches = 0;
+    for (int row = 0; row < H; ++row) {
+        for (int col = 0; col < W; ++col) {
+            PointLocation loc = star.LocatePoint(Point(-2.0 + (col + 0.5) * 0.1,
+                                                       -15.0 + (row + 0.5) * 0.1));
+            if (loc != PointLocation::OnEdge &&
+                (loc == PointLocation::Inside) != (tallMask[row * W + col] == 1)) {
+                ++tallMismatches;
+            }
+        }
+    }
+    ASSERT_TRUE("FillMask across many tiles matches LocatePoint", tallMismatches == 0, stats);
+}
+
+void TestPolygonPipeline(TestStats& stats) {
+    std::cout << "Running TestPolygonPipeline...\n";
+
+    // Regular k-gons of radius 1 with k cycling through 3..12.
+    const int COUNT = 500;
+    std::ostringstream text;
+    for (int i = 0; i < COUNT; ++i) {
+        int k = 3 + i % 10;
+        text << k << "\n";
+        for (int j = 0; j < k; ++j) {
+            double angle = 2.0 * M_PI * j / k;
+            text << std::cos(angle) << " , " << std::sin(angle) << "\n";
+        }
+        text << "Yes\n" << k << "\n" << 2.0 * k * std::sin(M_PI / k) << "\n\n";
+    }
+
+    // Tiny chunks and queues so records straddle chunks and stages block.
+    PolygonPipeline pipeline(4, 3, 16);
+    std::istringstream in(text.str());
+    long expectedIndex = 0;
+    bool inOrder = true;
+    bool metricsOk = true;
+    long count = pipeline.Run(in, [&](const PolygonRecord& record) {
+        inOrder = inOrder && record.index == expectedIndex;
+        ++expectedIndex;
+        int k = 3 + static_cast<int>(record.index % 10);
+        metricsOk = metricsOk &&
+                    record.polygon->GetNumPoints() == k &&
+                    record.expectedNumPoints == k &&
+                    record.convex &&
+                    AlmostEqual(record.perimeter, record.expectedPerimeter, 1e-4);
+    });
+    ASSERT_TRUE("Pipeline wrote every record", count == COUNT, stats);
+    ASSERT_TRUE("Pipeline keeps input order", inOrder && expectedIndex == COUNT, stats);
+    ASSERT_TRUE("Pipeline metrics match", metricsOk, stats);
+    ASSERT_TRUE("Pipeline no error", pipeline.GetError().empty(), stats);
+
+    std::istringstream bad("3\n0,0\n1;0\n0,1\nYes\n3\n3.41\n");
+    long badCount = pipeline.Run(bad, [](const PolygonRecord&) {});
+    ASSERT_TRUE("Pipeline rejects bad point", badCount == -1, stats);
+    ASSERT_TRUE("Pipeline reports bad point",
+                pipeline.GetError() == "Bad point format in polygon 1", stats);
+
+    std::istringstream truncated("3\n0,0\n1,0\n0,1\nYes\n");
+    ASSERT_TRUE("Pipeline rejects truncated record",
+                pipeline.Run(truncated, [](const PolygonRecord&) {}) == -1, stats);
+
+    std::istringstream empty("");
+    ASSERT_TRUE("Pipeline empty input",
+                pipeline.Run(empty, [](const PolygonRecord&) {}) == 0, stats);
+
+    // Exceptions from any stage reach the caller after every thread has stopped.
+    std::istringstream metricInput(text.str());
+    bool metricThrown = false;
+    try {
+        pipeline.Run(metricInput,
+                     [](PolygonRecord& record) {
+                         if (record.index == 100) throw std::runtime_error("metric");
+                         PolygonPipeline::ComputeMetrics(record);
+                     },
+                     [](const PolygonRecord&) {});
+    } catch (const std::runtime_error& error) {
+        metricThrown = std::string(error.what()) == "metric";
+    }
+    ASSERT_TRUE("Pipeline rethrows a metric exception", metricThrown, stats);
+
+    std::istringstream writeInput(text.str());
+    long writesSeen = 0;
+    bool writeThrown = false;
+    try {
+        pipeline.Run(writeInput, [&](const PolygonRecord& record) {
+            ++writesSeen;
+            if (record.index == 10) throw std::runtime_error("write");
+        });
+    } catch (const std::runtime_error& error) {
+        writeThrown = std::string(error.what()) == "write";
+    }
+    ASSERT_TRUE("Pipeline rethrows a write exception", writeThrown, stats);
+    ASSERT_TRUE("Pipeline stops writing after a write throws", writesSeen == 11, stats);
+}
+
+void TestPolygonCollection(TestStats& stats) {
+    std::cout << "Running TestPolygonCollection...\n";
+
+    Polygon square(4);
+    square.AddPoint(Point(0.0, 0.0));
+    square.AddPoint(Point(2.0, 0.0));
+    square.AddPoint(Point(2.0, 2.0));
+    square.AddPoint(Point(0.0, 2.0));
+
+    Polygon concave(5);
+    concave.AddPoint(Point(0.0, 0.0));
+    concave.AddPoint(Point(2.0, 0.0));
+    concave.AddPoint(Point(2.0, 2.0));
+    concave.AddPoint(Point(1.0, 1.0));
+    concave.AddPoint(Point(0.0, 2.0));
+
+    Polygon triangle(3);
+    triangle.AddPoint(Point(0.0, 0.0));
+    triangle.AddPoint(Point(3.0, 0.0));
+    triangle.AddPoint(Point(0.0, 4.0));
+
+    PolygonCollection collection;
+    ASSERT_TRUE("Collection Append index 0", collection.Append(square) == 0, stats);
+    ASSERT_TRUE("Collection Append index 1", collection.Append(concave) == 1, stats);
+    ASSERT_TRUE("Collection Append index 2", collection.Append(triangle) == 2, stats);
+    ASSERT_TRUE("Collection GetNumPolygons == 3", collection.GetNumPolygons() == 3, stats);
+    ASSERT_TRUE("Collection GetNumPoints == 12", collection.GetNumPoints() == 12, stats);
+
+    const Polygon* originals[3] = {&square, &concave, &triangle};
+    bool same = true;
+    for (int i = 0; i < 3; ++i) {
+        PolygonView view = collection.GetPolygon(i);
+        const Polygon& original = *originals[i];
+        same = same && view.GetNumPoints() == original.GetNumPoints();
+        same = same && view.Perimeter() == original.Perimeter();
+        same = same && view.IsConvex() == original.IsConvex();
+        for (int k = 0; k < 25; ++k) {
+            Point q(-0.25 + 0.125 * k, 2.1 - 0.1 * k);
+            same = same && view.LocatePoint(q) == original.LocatePoint(q);
+        }
+    }
+    ASSERT_TRUE("PolygonView matches Polygon", same, stats);
+    ASSERT_TRUE("PolygonView GetPoint",
+                collection.GetPolygon(2).GetPoint(2).Equals(Point(0.0, 4.0)), stats);
+    Polygon back = collection.GetPolygon(1).ToPolygon();
+    ASSERT_TRUE("PolygonView ToPolygon", back.GetNumPoints() == 5 &&
+                back.GetPoint(3)->Equals(Point(1.0, 1.0)), stats);
+
+    // Appending a view of the collection itself survives pool growth.
+    collection.Append(collection.GetPolygon(0));
+    ASSERT_CLOSE("Collection self-append", collection.GetPolygon(3).Perimeter(), 8.0, stats);
+
+    ASSERT_TRUE("Collection Remove", collection.Remove(1), stats);
+    ASSERT_TRUE("Collection Remove twice fails", !collection.Remove(1), stats);
+    ASSERT_TRUE("Collection IsRemoved", collection.IsRemoved(1), stats);
+    ASSERT_TRUE("Collection removed index stable",
+                collection.GetPolygon(2).GetNumPoints() == 3, stats);
+    collection.Compact();
+    ASSERT_TRUE("Compact GetNumPolygons == 3", collection.GetNumPolygons() == 3, stats);
+    ASSERT_TRUE("Compact GetNumPoints == 11", collection.GetNumPoints() == 11, stats);
+    ASSERT_TRUE("Compact GetNumRemoved == 0", collection.GetNumRemoved() == 0, stats);
+    ASSERT_CLOSE("Compact keeps order #1", collection.GetPolygon(1).Perimeter(), 12.0, stats);
+    ASSERT_CLOSE("Compact keeps order #2", collection.GetPolygon(2).Perimeter(), 8.0, stats);
+
+    std::istringstream text("3\n1.0,1.0\n1.0,4.0\n4.0,1.0\nYes\n3\n10.24\n\n"
+                            "4\n0,0\n1,0\n1,1\n0,1\nYes\n4\n4.0\n");
+    std::string error;
+    PolygonCollection loaded;
+    ASSERT_TRUE("LoadFromStream count", loaded.LoadFromStream(text, error) == 2, stats);
+    ASSERT_CLOSE("LoadFromStream perimeter", loaded.GetPolygon(1).Perimeter(), 4.0, stats);
+
+    std::istringstream broken("3\n1.0,1.0\n");
+    ASSERT_TRUE("LoadFromStream malformed", loaded.LoadFromStream(broken, error) == -1, stats);
+    ASSERT_TRUE("LoadFromStream error message", !error.empty(), stats);
+    ASSERT_TRUE("LoadFromStream drops a partial polygon",
+                loaded.GetNumPolygons() == 2 && loaded.GetNumPoints() == 7, stats);
+}
+
+void TestAffineTransform(TestStats& stats) {
+    std::cout << "Running TestAffineTransform...\n";
+
+    // Rotate a quarter turn, then move right by 10.
+    AffineTransform transform =
+        AffineTransform::Rotation(M_PI / 2.0).Then(AffineTransform::Translation(10.0, 0.0));
+    Point moved = transform.Apply(Point(1.0, 0.0));
+    ASSERT_TRUE("AffineTransform Then order",
+                AlmostEqual(moved.GetX(), 10.0) && AlmostEqual(moved.GetY(), 1.0), stats);
+    Point scaled = AffineTransform::Scaling(2.0, 3.0).Apply(Point(1.0, 1.0));
+    ASSERT_TRUE("AffineTransform Scaling",
+                AlmostEqual(scaled.GetX(), 2.0) && AlmostEqual(scaled.GetY(), 3.0), stats);
+
+    Polygon square(4);
+    square.AddPoint(Point(0.0, 0.0));
+    square.AddPoint(Point(2.0, 0.0));
+    square.AddPoint(Point(2.0, 2.0));
+    square.AddPoint(Point(0.0, 2.0));
+    const Point* before = square.GetPoint(1);
+    ASSERT_CLOSE("Transform setup distance", square.DistanceToBoundary(Point(5.0, 1.0)), 3.0, stats);
+
+    BoundingBox box;
+    square.Transform(transform, &box);
+    ASSERT_TRUE("Polygon::Transform keeps point storage", square.GetPoint(1) == before, stats);
+    ASSERT_TRUE("Polygon::Transform moved point",
+                AlmostEqual(square.GetPoint(1)->GetX(), 10.0) &&
+                AlmostEqual(square.GetPoint(1)->GetY(), 2.0), stats);
+    ASSERT_TRUE("Polygon::Transform bounding box",
+                AlmostEqual(box.minX, 8.0) && AlmostEqual(box.maxX, 10.0) &&
+                AlmostEqual(box.minY, 0.0) && AlmostEqual(box.maxY, 2.0), stats);
+    ASSERT_CLOSE("Polygon::Transform keeps perimeter", square.Perimeter(), 8.0, stats);
+    ASSERT_CLOSE("Polygon::Transform refreshes caches",
+                 square.DistanceToBoundary(Point(5.0, 1.0)), 3.0, stats);
+
+    square.SetPoint(0, Point(7.0, 0.0));
+    ASSERT_TRUE("SetPoint keeps point storage", square.GetPoint(1) == before, stats);
+
+    // Arrays of polygons and collections, serial and threaded.
+    std::vector<Polygon> polygons;
+    PolygonCollection serial;
+    PolygonCollection threaded;
+    for (int i = 0; i < 97; ++i) {
+        polygons.push_back(MakeStar(4 + i % 9 * 2, i, -i, 1.0, 2.0 + i % 3));
+        serial.Append(polygons.back());
+        threaded.Append(polygons.back());
+    }
+    std::vector<Polygon> reference(polygons);
+
+    AffineTransform spin = AffineTransform::Scaling(1.5, 0.5)
+        .Then(AffineTransform::Rotation(0.3))
+        .Then(AffineTransform::Translation(-4.0, 2.5));
+    std::vector<BoundingBox> arrayBoxes(polygons.size());
+    std::vector<BoundingBox> serialBoxes(polygons.size());
+    std::vector<BoundingBox> threadedBoxes(polygons.size());
+    Polygon::TransformAll(polygons.data(), static_cast<int>(polygons.size()), spin,
+                          arrayBoxes.data(), 4);
+    serial.Transform(spin, serialBoxes.data());
+    threaded.Transform(spin, threadedBoxes.data(), 4);
+
+    bool match = true;
+    for (size_t i = 0; i < polygons.size(); ++i) {
+        reference[i].Transform(spin);
+        PolygonView a = serial.GetPolygon(static_cast<int>(i));
+        PolygonView b = threaded.GetPolygon(static_cast<int>(i));
+        for (int k = 0; k < a.GetNumPoints(); ++k) {
+            Point expected = *reference[i].GetPoint(k);
+            match = match && polygons[i].GetPoint(k)->Equals(expected);
+            match = match && a.GetPoint(k).Equals(expected) && b.GetPoint(k).Equals(expected);
+        }
+        match = match && serialBoxes[i].minX == threadedBoxes[i].minX &&
+                serialBoxes[i].maxY == threadedBoxes[i].maxY &&
+                arrayBoxes[i].minY == serialBoxes[i].minY &&
+                arrayBoxes[i].maxX == serialBoxes[i].maxX;
+    }
+    ASSERT_TRUE("TransformAll and collection Transform agree", match, stats);
+
+    threaded.Transform(AffineTransform::Translation(1.0, 1.0), nullptr, 0);
+    serial.Transform(AffineTransform::Translation(1.0, 1.0));
+    ASSERT_TRUE("Collection Transform without boxes",
+                threaded.GetPolygon(50).GetPoint(3).Equals(serial.GetPolygon(50).GetPoint(3)),
+                stats);
+}
+
+bool HasPoint(const Polygon& poly, double x, double y) {
+    for (int i = 0; i < poly.GetNumPoints(); ++i) {
+        if (AlmostEqual(poly.GetPoint(i)->GetX(), x) && AlmostEqual(poly.GetPoint(i)->GetY(), y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TestMinkowskiAndOffset(TestStats& stats) {
+    std::cout << "Running TestMinkowskiAndOffset...\n";
+
+    Polygon square(4);
+    square.AddPoint(Point(0.0, 0.0));
+    square.AddPoint(Point(2.0, 0.0));
+    square.AddPoint(Point(2.0, 2.0));
+    square.AddPoint(Point(0.0, 2.0));
+
+    Polygon unitCw(4); // clockwise on purpose
+    unitCw.AddPoint(Point(0.0, 0.0));
+    unitCw.AddPoint(Point(0.0, 1.0));
+    unitCw.AddPoint(Point(1.0, 1.0));
+    unitCw.AddPoint(Point(1.0, 0.0));
+
+    Polygon sum(8);
+    ASSERT_TRUE("MinkowskiSum squares ok", square.MinkowskiSum(unitCw, sum), stats);
+    ASSERT_TRUE("MinkowskiSum squares merges parallel edges", sum.GetNumPoints() == 4, stats);
+    ASSERT_CLOSE("MinkowskiSum squares perimeter", sum.Perimeter(), 12.0, stats);
+    ASSERT_TRUE("MinkowskiSum squares corner", HasPoint(sum, 3.0, 3.0), stats);
+
+    Polygon triangle(3);
+    triangle.AddPoint(Point(0.0, 0.0));
+    triangle.AddPoint(Point(1.0, 0.0));
+    triangle.AddPoint(Point(0.0, 1.0));
+    Polygon sum2(7);
+    ASSERT_TRUE("MinkowskiSum triangle ok", triangle.MinkowskiSum(unitCw, sum2), stats);
+    ASSERT_TRUE("MinkowskiSum triangle 5 points", sum2.GetNumPoints() == 5, stats);
+    ASSERT_CLOSE("MinkowskiSum perimeter adds up", sum2.Perimeter(),
+                 triangle.Perimeter() + unitCw.Perimeter(), stats);
+    ASSERT_TRUE("MinkowskiSum is convex", sum2.IsConvex(), stats);
+
+    Polygon concave(5);
+    concave.AddPoint(Point(0.0, 0.0));
+    concave.AddPoint(Point(2.0, 0.0));
+    concave.AddPoint(Point(2.0, 2.0));
+    concave.AddPoint(Point(1.0, 1.0));
+    concave.AddPoint(Point(0.0, 2.0));
+    Polygon big(20);
+    ASSERT_TRUE("MinkowskiSum rejects concave", !concave.MinkowskiSum(square, big), stats);
+    Polygon tiny(5);
+    ASSERT_TRUE("MinkowskiSum rejects small result", !square.MinkowskiSum(unitCw, tiny), stats);
+    ASSERT_TRUE("MinkowskiSum rejects aliasing", !square.MinkowskiSum(unitCw, square), stats);
+    Polygon pentagram(5);
+    for (int i = 0; i < 5; ++i) {
+        double angle = M_PI / 2.0 + 4.0 * M_PI * i / 5.0;
+        pentagram.AddPoint(Point(std::cos(angle), std::sin(angle)));
+    }
+    ASSERT_TRUE("MinkowskiSum rejects a pentagram", pentagram.IsConvex() &&
+                !pentagram.MinkowskiSum(unitCw, big) && !unitCw.MinkowskiSum(pentagram, big),
+                stats);
+
+    // Repeated vertices and closed rings give zero-length edges to skip.
+    auto area = [](const Polygon& poly) {
+        double twice = 0.0;
+        for (int i = 0, n = poly.GetNumPoints(); i < n; ++i) {
+            const Point* p = poly.GetPoint(i);
+            const Point* q = poly.GetPoint((i + 1) % n);
+            twice += p->GetX() * q->GetY() - q->GetX() * p->GetY();
+        }
+        return std::fabs(twice) / 2.0;
+    };
+    Polygon ring(5);
+    ring.AddPoint(Point(3.0, 0.0));
+    ring.AddPoint(Point(3.0, 3.0));
+    ring.AddPoint(Point(0.0, 3.0));
+    ring.AddPoint(Point(0.0, 0.0));
+    ring.AddPoint(Point(0.0, 0.0));
+    Polygon wedge(3);
+    wedge.AddPoint(Point(1.0, -1.0));
+    wedge.AddPoint(Point(-2.0, 2.0));
+    wedge.AddPoint(Point(-2.0, -2.0));
+    Polygon ringSum(8);
+    ASSERT_TRUE("MinkowskiSum closed ring ok", ring.MinkowskiSum(wedge, ringSum), stats);
+    ASSERT_CLOSE("MinkowskiSum closed ring area", area(ringSum), 36.0, stats);
+
+    Polygon doubled(5);
+    doubled.AddPoint(Point(0.0, 0.0));
+    doubled.AddPoint(Point(0.0, 0.0));
+    doubled.AddPoint(Point(3.0, 0.0));
+    doubled.AddPoint(Point(3.0, 1.0));
+    doubled.AddPoint(Point(0.0, 1.0));
+    Polygon plain(4);
+    for (int i = 1; i < 5; ++i) {
+        plain.AddPoint(*doubled.GetPoint(i));
+    }
+    Polygon fan(3);
+    fan.AddPoint(Point(-1.0, 0.0));
+    fan.AddPoint(Point(-1.0, -2.0));
+    fan.AddPoint(Point(2.0, 2.0));
+    Polygon doubledSum(8);
+    Polygon plainSum(8);
+    ASSERT_TRUE("MinkowskiSum repeated vertex ok", doubled.MinkowskiSum(fan, doubledSum) &&
+                plain.MinkowskiSum(fan, plainSum), stats);
+    ASSERT_TRUE("MinkowskiSum repeated vertex same as without",
+                doubledSum.GetNumPoints() == plainSum.GetNumPoints() &&
+                AlmostEqual(area(doubledSum), area(plainSum)), stats);
+
+    // Every vertex repeated leaves no two consecutive edges of nonzero length.
+    Polygon twice(6);
+    for (int i = 0; i < 3; ++i) {
+        twice.AddPoint(*fan.GetPoint(i));
+        twice.AddPoint(*fan.GetPoint(i));
+    }
+    Polygon twiceSum(9);
+    ASSERT_TRUE("IsConvex skips repeated points", twice.IsConvex(), stats);
+    ASSERT_TRUE("MinkowskiSum every vertex repeated", twice.MinkowskiSum(fan, twiceSum) &&
+                AlmostEqual(area(twiceSum), 4.0 * area(fan)), stats);
+
+    // Refilling a preallocated result reuses its points.
+    const Point* slot = sum.GetPoint(0);
+    square.MinkowskiSum(unitCw, sum);
+    ASSERT_TRUE("MinkowskiSum reuses result points", sum.GetPoint(0) == slot, stats);
+    sum.Clear();
+    ASSERT_TRUE("Clear empties polygon", sum.GetNumPoints() == 0, stats);
+    sum.AddPoint(Point(9.0, 9.0));
+    ASSERT_TRUE("AddPoint after Clear reuses point", sum.GetPoint(0) == slot, stats);
+
+    Polygon offset(40);
+    ASSERT_TRUE("Offset miter ok", square.Offset(1.0, JoinStyle::Miter, offset), stats);
+    ASSERT_TRUE("Offset miter 4 points", offset.GetNumPoints() == 4, stats);
+    ASSERT_TRUE("Offset miter corner", HasPoint(offset, -1.0, -1.0) &&
+                HasPoint(offset, 3.0, 3.0), stats);
+    ASSERT_TRUE("Offset inset", square.Offset(-0.5, JoinStyle::Round, offset) &&
+                offset.GetNumPoints() == 4 && HasPoint(offset, 0.5, 0.5), stats);
+    ASSERT_TRUE("Offset clockwise", unitCw.Offset(1.0, JoinStyle::Miter, offset) &&
+                HasPoint(offset, 2.0, 2.0) && HasPoint(offset, -1.0, -1.0), stats);
+
+    ASSERT_TRUE("Offset round ok", square.Offset(1.0, JoinStyle::Round, offset, 8), stats);
+    ASSERT_TRUE("Offset round points", offset.GetNumPoints() == 36, stats);
+    ASSERT_TRUE("Offset round perimeter",
+                AlmostEqual(offset.Perimeter(), 8.0 + 2.0 * M_PI, 0.02), stats);
+    bool onCircle = true;
+    for (int i = 0; i < offset.GetNumPoints(); ++i) {
+        onCircle = onCircle && AlmostEqual(square.DistanceToBoundary(*offset.GetPoint(i)), 1.0);
+    }
+    ASSERT_TRUE("Offset round points at distance 1", onCircle, stats);
+
+    // L-shape: the reflex corner (1,1) moves to the meeting point (1.5,1.5).
+    Polygon ell(6);
+    ell.AddPoint(Point(0.0, 0.0));
+    ell.AddPoint(Point(2.0, 0.0));
+    ell.AddPoint(Point(2.0, 1.0));
+    ell.AddPoint(Point(1.0, 1.0));
+    ell.AddPoint(Point(1.0, 2.0));
+    ell.AddPoint(Point(0.0, 2.0));
+    ASSERT_TRUE("Offset concave ok", ell.Offset(0.5, JoinStyle::Round, offset, 4), stats);
+    ASSERT_TRUE("Offset concave reflex corner", HasPoint(offset, 1.5, 1.5), stats);
+    ASSERT_TRUE("Offset concave arc", HasPoint(offset, 2.5, 0.0) && HasPoint(offset, 2.0, -0.5),
+                stats);
+
+    // A sharp spike gets bevelled past the miter limit.
+    Polygon spike(3);
+    spike.AddPoint(Point(0.0, 0.0));
+    spike.AddPoint(Point(10.0, 0.5));
+    spike.AddPoint(Point(0.0, 1.0));
+    ASSERT_TRUE("Offset miter limit bevels", spike.Offset(0.1, JoinStyle::Miter, offset, 8, 2.0) &&
+                offset.GetNumPoints() == 4, stats);
+    Polygon small(3);
+    ASSERT_TRUE("Offset rejects small result", !square.Offset(1.0, JoinStyle::Round, small), stats);
+}
+
+void TestConvexLocatePoint(TestStats& stats) {
+    std::cout << "Running TestConvexLocatePoint...\n";
+
+    // Hexagon with an extra collinear vertex, in both orientations.
+    const double xs[] = {2.0, 1.0, -1.0, -2.0, -1.0, 0.0, 1.0};
+    const double ys[] = {0.0, 1.5, 1.5, 0.0, -1.5, -1.5, -1.5};
+    const int N = 7;
+    Polygon ccw(N);
+    Polygon cw(N);
+    for (int i = 0; i < N; ++i) {
+        ccw.AddPoint(Point(xs[i], ys[i]));
+        cw.AddPoint(Point(xs[N - 1 - i], ys[N - 1 - i]));
+    }
+
+    for (const Polygon* polygon : {&ccw, &cw}) {
+        bool agree = true;
+        for (double x = -2.5; x <= 2.5; x += 0.13) {
+            for (double y = -2.0; y <= 2.0; y += 0.11) {
+                Point q(x, y);
+                agree = agree && polygon->LocatePoint(q) == polygon->LocatePointLinear(q);
+            }
+        }
+        ASSERT_TRUE("Convex LocatePoint matches linear on a grid", agree, stats);
+
+        bool onEdge = true;
+        for (int i = 0; i < N; ++i) {
+            const Point& a = *polygon->GetPoint(i);
+            const Point& b = *polygon->GetPoint((i + 1) % N);
+            Point middle((a.GetX() + b.GetX()) / 2.0, (a.GetY() + b.GetY()) / 2.0);
+            onEdge = onEdge && polygon->LocatePoint(a) == PointLocation::OnEdge &&
+                     polygon->LocatePoint(middle) == PointLocation::OnEdge;
+        }
+        ASSERT_TRUE("Convex LocatePoint finds vertices and edges", onEdge, stats);
+    }
+    ASSERT_TRUE("Convex LocatePoint behind pivot",
+                ccw.LocatePoint(Point(3.0, 0.0)) == PointLocation::Outside, stats);
+    ASSERT_TRUE("Convex LocatePoint on pivot diagonal",
+                ccw.LocatePoint(Point(0.0, 0.0)) == PointLocation::Inside, stats);
+
+    // A closed ring repeats its first vertex at the end.
+    Polygon ring(5);
+    ring.AddPoint(Point(0.0, 0.0));
+    ring.AddPoint(Point(2.0, 0.0));
+    ring.AddPoint(Point(2.0, 2.0));
+    ring.AddPoint(Point(0.0, 2.0));
+    ring.AddPoint(Point(0.0, 0.0));
+    ASSERT_TRUE("Closed ring inside", ring.LocatePoint(Point(1.5, 0.5)) == PointLocation::Inside,
+                stats);
+    ASSERT_TRUE("Closed ring outside", ring.LocatePoint(Point(2.5, 0.5)) == PointLocation::Outside,
+                stats);
+    ASSERT_TRUE("Closed ring edges", ring.LocatePoint(Point(1.0, 0.0)) == PointLocation::OnEdge &&
+                ring.LocatePoint(Point(2.0, 1.0)) == PointLocation::OnEdge &&
+                ring.LocatePoint(Point(0.0, 1.0)) == PointLocation::OnEdge, stats);
+
+    // The cached convexity follows modifications of the polygon.
+    Polygon square(4);
+    square.AddPoint(Point(0.0, 0.0));
+    square.AddPoint(Point(4.0, 0.0));
+    square.AddPoint(Point(4.0, 4.0));
+    square.AddPoint(Point(0.0, 4.0));
+    Point probe(3.0, 2.5);
+    ASSERT_TRUE("Cached convex square inside",
+                square.IsConvex() && square.LocatePoint(probe) == PointLocation::Inside, stats);
+    square.SetPoint(2, Point(1.0, 1.0));
+    ASSERT_TRUE("SetPoint resets convexity", !square.IsConvex(), stats);
+    ASSERT_TRUE("Concave square outside", square.LocatePoint(probe) == PointLocation::Outside,
+                stats);
+    square.SetPoint(2, Point(4.0, 4.0));
+    square.Transform(AffineTransform::Scaling(-1.0, 1.0));
+    ASSERT_TRUE("Mirrored square inside",
+                square.LocatePoint(Point(-3.0, 2.5)) == PointLocation::Inside &&
+                square.LocatePoint(probe) == PointLocation::Outside, stats);
+
+    // All turns go the same way, but the boundary winds around twice.
+    Polygon pentagram(5);
+    for (int i = 0; i < 5; ++i) {
+        double angle = M_PI / 2.0 + 4.0 * M_PI * i / 5.0;
+        pentagram.AddPoint(Point(std::cos(angle), std::sin(angle)));
+    }
+    ASSERT_TRUE("Pentagram passes IsConvex", pentagram.IsConvex(), stats);
+    ASSERT_TRUE("Pentagram center uses crossing parity",
+                pentagram.LocatePoint(Point(0.0, 0.0)) == PointLocation::Outside, stats);
+    ASSERT_TRUE("Pentagram point uses crossing parity",
+                pentagram.LocatePoint(Point(0.0, 0.7)) == PointLocation::Inside, stats);
+
+    // Views share the classification and crossing test with Polygon.
+    PolygonCollection shapes;
+    shapes.Append(pentagram);
+    shapes.Append(ring);
+    ASSERT_TRUE("PolygonView pentagram matches Polygon",
+                shapes.GetPolygon(0).IsConvex() &&
+                shapes.GetPolygon(0).LocatePoint(Point(0.0, 0.0)) == PointLocation::Outside,
+                stats);
+    ASSERT_TRUE("PolygonView closed ring matches Polygon",
+                shapes.GetPolygon(1).IsConvex() &&
+                shapes.GetPolygon(1).LocatePoint(Point(1.0, 0.0)) == PointLocation::OnEdge,
+                stats);
+
+    // Several threads make the first, cache-filling queries at the same time.
+    Polygon shared = MakeStar(400, 0.0, 0.0, 3.0, 6.0);
+    Polygon sharedConvex = MakeStar(400, 0.0, 0.0, 5.0, 5.0);
+    const int THREADS = 4;
+    std::vector<double> distances(THREADS);
+    std::vector<int> locations(THREADS);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < THREADS; ++t) {
+        pool.emplace_back([&, t]() {
+            distances[t] = shared.DistanceToBoundary(Point(0.5, 0.25));
+            locations[t] = static_cast<int>(sharedConvex.LocatePoint(Point(1.0, 1.0)));
+        });
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    bool same = true;
+    for (int t = 0; t < THREADS; ++t) {
+        same = same && distances[t] == distances[0] &&
+               locations[t] == static_cast<int>(PointLocation::Inside);
+    }
+    ASSERT_TRUE("Concurrent first queries agree", same, stats);
+}
 
 // ----------------- main -----------------
 
@@ -225,7 +1060,14 @@ int main() {
     TestPolygonSquareConvex(stats);
     TestPolygonConcave(stats);
     TestPolygonCopyAndAssign(stats);
-    TestPolygonLocatePoint(stats);    
+    TestPolygonLocatePoint(stats);
+    TestPolygonDistance(stats);
+    TestRasterizer(stats);
+    TestPolygonPipeline(stats);
+    TestPolygonCollection(stats);
+    TestAffineTransform(stats);
+    TestMinkowskiAndOffset(stats);
+    TestConvexLocatePoint(stats);
 
     std::cout << "\n=== TEST SUMMARY ===\n";
     std::cout << "Passed: " << stats.passed << "\n";